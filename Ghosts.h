@@ -1,924 +1,1076 @@
-﻿#include "entity.h"
-#include "animation.h"
-#include "maze.h"
-#include <SFML/Graphics.hpp>
-#include <string>
-#include <iostream>
-#include <map>
-#include <vector>
-#include <cstdlib>
-#include <ctime>
-#include <cmath>
-
-class Ghost : public Entity {
-protected:
-    sf::Texture texture;
-    Animation animation;
-    Direction currentDirection;
-    sf::Vector2f initialPosition;
-    int frameWidth, frameHeight;
-    float behaviorTimer;     // Timer for ghost behaviors
-    bool isScattered;        // For alternating between scatter and random movement
-    float scatterTimer;      // For timing scatter/random phases
-    const float SCATTER_DURATION = 7.0f;  // Seconds in scatter mode
-    sf::Color originalColor; // Store the original color for restoration after super mode
-
-    // Constants for cell-based movement
-    static const int CELL_SIZE = 40;
-
-public:
-    Ghost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Entity(x, y, speed),
-        animation(0.1f),
-        currentDirection(LEFT),
-        initialPosition(x, y),
-        frameWidth(frameWidth),
-        frameHeight(frameHeight),
-        behaviorTimer(0.0f),
-        isScattered(true),
-        scatterTimer(0.0f)
-    {
-        if (!texture.loadFromFile(spriteSheetPath)) {
-            std::cerr << "Failed to load ghost texture: " << spriteSheetPath << std::endl;
-        }
-
-        sprite.setTexture(texture);
-        sprite.setScale(scale, scale);
-        sprite.setPosition(position);
-        originalColor = sprite.getColor(); // Store the original color
-
-        for (int i = 0; i < frameCount; ++i) {
-            animation.addFrame(sf::IntRect(i * frameWidth, 0, frameWidth, frameHeight)); // horizontal layout
-        }
-
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    }
-    void setSpeed(float newSpeed) { speed = newSpeed; }
-    float getOriginalSpeed() const { return speed; }
-    virtual ~Ghost() = default;
-
-    virtual bool Move(Direction dir, Maze& maze) {
-        Vector2f tempPosition = position;
-        float moveDist = speed;
-
-        switch (dir) {
-        case RIGHT: tempPosition.x += moveDist; break;
-        case LEFT:  tempPosition.x -= moveDist; break;
-        case UP:    tempPosition.y -= moveDist; break;
-        case DOWN:  tempPosition.y += moveDist; break;
-        }
-
-        float mazeWidth = Maze::getWidth() * Maze::getCellSize() + maze.getOffset().x;
-        if (tempPosition.x < maze.getOffset().x) {
-            tempPosition.x = mazeWidth - sprite.getGlobalBounds().width - 10;
-        }
-        else if (tempPosition.x + sprite.getGlobalBounds().width > mazeWidth-10) {
-            tempPosition.x = maze.getOffset().x + 10;
-        }
-
-        if (isValidDirection(maze, dir)) {
-            position = tempPosition;
-            currentDirection = dir;
-            sprite.setPosition(position);
-            return true;  // Move succeeded
-        }
-
-        return false;  // Blocked by wall
-    }
-
-    void menMove(Direction dir) {
-        currentDirection = dir;
-
-        switch (dir) {
-        case LEFT:  position.x -= speed; break;
-        case RIGHT: position.x += speed; break;
-        case UP:    position.y -= speed; break;
-        case DOWN:  position.y += speed; break;
-        }
-
-        sprite.setPosition(position);
-        Update(1.0f / 60.0f);
-    }
-
-    virtual void Update(float deltaTime) {
-        animation.updateGhost(currentDirection, sprite);
-    }
-
-    virtual void Reset() {
-        position = initialPosition;
-        sprite.setPosition(position);
-        currentDirection = LEFT;
-        isScattered = true;
-        scatterTimer = 0.0f;
-        behaviorTimer = 0.0f;
-        animation.reset();
-        sprite.setColor(originalColor); // Reset to original color
-    }
-
-    sf::Vector2f GetPosition() const {
-        return position;
-    }
-
-    void SetPosition(float x, float y) {
-        position.x = x;
-        position.y = y;
-        sprite.setPosition(position);
-    }
-
-    virtual sf::Sprite getSprite() const {
-        return sprite;
-    }
-
-    virtual bool GhostCollision(const sf::Vector2f& pacmanPosition) const {
-        sf::FloatRect pacmanBounds(
-            pacmanPosition.x - 20.f, // center the 40x40 box around pacmanPosition
-            pacmanPosition.y - 20.f,
-            40.f,
-            40.f
-        );
-
-        return sprite.getGlobalBounds().intersects(pacmanBounds);
-    }
-
-    virtual void updateAutonomous(Maze& maze) {
-        float deltaTime = 1.0f / 60.0f;
-
-        // Try to move in current direction
-        if (!Move(currentDirection, maze)) {
-            // If blocked, pick a new valid direction (excluding opposite)
-            std::vector<Direction> possibleDirs;
-
-            for (int d = 0; d < 4; ++d) {
-                Direction dir = static_cast<Direction>(d);
-                if (dir == getOpposite(currentDirection)) continue;
-
-                if (isValidDirection(maze, dir)) {
-                    possibleDirs.push_back(dir);
-                }
-            }
-
-            if (!possibleDirs.empty()) {
-                currentDirection = possibleDirs[std::rand() % possibleDirs.size()];
-                Move(currentDirection, maze);  // Try the new direction immediately
-            }
-        }
-
-        Update(deltaTime);
-    }
-
-    Direction GetCurrentDirection() const {
-        return currentDirection;
-    }
-
-    std::vector<Direction> getAvailableDirections(Maze& maze) {
-        std::vector<Direction> dirs;
-        Vector2f testPos;
-
-        // Try each direction, excluding the opposite of current direction
-        for (int d = 0; d < 4; ++d) {
-            Direction dir = static_cast<Direction>(d);
-
-            // Skip the opposite direction (no backtracking)
-            if (dir == getOpposite(currentDirection)) {
-                continue;
-            }
-
-            testPos = position;
-
-            // Check the position for each direction
-            switch (dir) {
-            case UP:    testPos.y -= CELL_SIZE; break;
-            case DOWN:  testPos.y += CELL_SIZE; break;
-            case LEFT:  testPos.x -= CELL_SIZE; break;
-            case RIGHT: testPos.x += CELL_SIZE; break;
-            }
-
-            // If the new position is walkable, add this direction to the list
-            if (maze.isWalkable(testPos)) {
-                dirs.push_back(dir);
-            }
-        }
-
-        // If no directions are valid (i.e., dead-end), go back
-        if (dirs.empty()) {
-            dirs.push_back(getOpposite(currentDirection));
-        }
-
-        return dirs;
-    }
-
-    Direction getOpposite(Direction dir) const {
-        switch (dir) {
-        case UP: return DOWN;
-        case DOWN: return UP;
-        case LEFT: return RIGHT;
-        case RIGHT: return LEFT;
-        default: return LEFT;
-        }
-    }
-
-    bool isAwayFromCenterEnough() const {
-        float minDistance = 25.0f;  // Ghost must be at least this far from cell center
-
-        float centerX = std::round(position.x / CELL_SIZE) * CELL_SIZE + (CELL_SIZE / 2);
-        float centerY = std::round(position.y / CELL_SIZE) * CELL_SIZE + (CELL_SIZE / 2);
-
-        float dx = std::abs(position.x - centerX);
-        float dy = std::abs(position.y - centerY);
-
-        return dx > minDistance || dy > minDistance;
-    }
-
-    bool isValidDirection(Maze& maze, Direction dir) {
-        Vector2f testPos = position;
-
-        // Round to center of current cell
-        testPos.x = std::floor(testPos.x / CELL_SIZE) * CELL_SIZE + CELL_SIZE / 2;
-        testPos.y = std::floor(testPos.y / CELL_SIZE) * CELL_SIZE + CELL_SIZE / 2;
-
-        // Move one full cell in the given direction
-        switch (dir) {
-        case RIGHT: testPos.x += CELL_SIZE; break;
-        case LEFT:  testPos.x -= CELL_SIZE; break;
-        case UP:    testPos.y -= CELL_SIZE; break;
-        case DOWN:  testPos.y += CELL_SIZE; break;
-        }
-
-        return maze.isWalkable(testPos);
-    }
-
-    void SuperSpeed() {
-        speed += 1.f;  // Increase speed   
-    }
-
-    void ResetSpeed() {
-        speed -= 1.f;  // Reset speed
-    }
-
-    // Set the color of the ghost for super mode
-    void setColor(const sf::Color& color) {
-        sprite.setColor(color);
-    }
-
-    // Get the original color of the ghost
-    sf::Color getOriginalColor() const {
-        return originalColor;
-    }
-};
-
-class RingGhost : public Ghost {
-private:
-    bool isVisible;
-    float visibilityTimer;
-    const float INVISIBLE_DURATION = 3.0f;
-    const float VISIBLE_DURATION = 5.0f;
-    const float BLINK_WARNING_DURATION = 1.0f;  // Duration of blinking warning before state change
-    bool isBlinking;  // Flag to indicate if ghost is currently blinking
-    float blinkTimer;  // Timer for controlling blink frequency
-
-public:
-    RingGhost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
-        isVisible(true),
-        visibilityTimer(0.0f),
-        isBlinking(false),
-        blinkTimer(0.0f) {
-        updateVisibility();
-    }
-
-    bool getIsVisible() const { return isVisible; }
-    float getVisibilityTimer() const { return visibilityTimer; }
-    bool getIsBlinking() const { return isBlinking; }
-
-    void Update(float deltaTime) override {
-        Ghost::Update(deltaTime);
-        visibilityTimer += deltaTime;
-
-        // Check if we need to start blinking before state change
-        if (isVisible && !isBlinking && visibilityTimer >= VISIBLE_DURATION - BLINK_WARNING_DURATION) {
-            isBlinking = true;
-            blinkTimer = 0.0f;
-        }
-        else if (!isVisible && !isBlinking && visibilityTimer >= INVISIBLE_DURATION - BLINK_WARNING_DURATION) {
-            isBlinking = true;
-            blinkTimer = 0.0f;
-        }
-
-        // Handle blinking effect
-        if (isBlinking) {
-            blinkTimer += deltaTime;
-
-            // Toggle visibility rapidly (10 times per second)
-            sf::Color color = sprite.getColor();
-            if (static_cast<int>(blinkTimer * 10) % 2 == 0) {
-                color.a = 255;  // Fully visible
-            }
-            else {
-                color.a = 80;   // Semi-transparent
-            }
-            setColor(color);
-
-            // Check if blinking period is over and we need to change state
-            if ((isVisible && visibilityTimer >= VISIBLE_DURATION) ||
-                (!isVisible && visibilityTimer >= INVISIBLE_DURATION)) {
-                // Change visibility state
-                isVisible = !isVisible;
-                isBlinking = false;
-                visibilityTimer = 0.0f;
-                updateVisibility();
-            }
-        }
-    }
-
-    void updateVisibility() {
-        sf::Color color = sprite.getColor();
-        color.a = isVisible ? 255 : 0; // Full opacity when visible, transparent when invisible
-        setColor(color);
-    }
-
-    // Override the getSprite method to control visibility
-    sf::Sprite getSprite() const override {
-        return Ghost::getSprite();
-    }
-
-    // RingGhost can still collide even when invisible
-    bool GhostCollision(const sf::Vector2f& pacmanPosition) const override {
-        // Ghost can collide even when invisible
-        return Ghost::GhostCollision(pacmanPosition);
-    }
-
-    void Reset() override {
-        Ghost::Reset();
-        isVisible = true;
-        visibilityTimer = 0.0f;
-        isBlinking = false;
-        blinkTimer = 0.0f;
-        updateVisibility();
-    }
-};
-
-class TeleporterGhost : public Ghost {
-private:
-    float teleportTimer;            // Track time until next teleport
-    const float TELEPORT_INTERVAL = 10.0f;  // Seconds between teleports
-    const float FLICKER_DURATION = 2.0f;    // Duration of flickering before teleport
-    bool isFlickering;              // Flag for flickering state
-    float flickerTimer;             // Timer for controlling flicker frequency
-    std::vector<sf::Vector2f> teleportLocations; // Predefined teleport locations
-
-public:
-    TeleporterGhost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
-        teleportTimer(0.0f),
-        isFlickering(false),
-        flickerTimer(0.0f)
-    {
-        // Initialize predefined teleport locations (adjust coordinates based on your maze)
-        initTeleportLocations();
-    }
-
-    void initTeleportLocations() {
-        // Define 8 valid teleport locations based on the provided grid coordinates
-        // Converting grid positions to pixel positions with CELL_SIZE = 40
-        // For each grid position (x,y), calculate pixel position as (x*40 + offset.x, y*40 + offset.y)
-        // to place the ghost at the correct position accounting for maze offset
-
-        const sf::Vector2f offset(60.f, 40.f); // Maze offset
-
-        const std::vector<sf::Vector2i> TELEPORT_POINTS = {
-            {2, 1},   // Top-left corner
-            {17, 1},  // Top-right
-            {2, 15},  // Bottom-left
-            {17, 15}, // Bottom-right
-            {9, 4},   // Center-top
-            {9, 12},  // Center-bottom
-            {4, 9},   // Left-center
-            {14, 9}   // Right-center
-        };
-
-        teleportLocations.clear();
-        // Convert grid coordinates to pixel coordinates with offset
-        for (const auto& point : TELEPORT_POINTS) {
-            // Calculate center of the tile with offset
-            float x = point.x * CELL_SIZE + offset.x;
-            float y = point.y * CELL_SIZE + offset.y;
-            teleportLocations.push_back(sf::Vector2f(x, y));
-        }
-    }
-
-void Update(float deltaTime) override {
-    Ghost::Update(deltaTime);
-    teleportTimer += deltaTime;
-
-    // Check if it's time to start flickering before teleport
-    if (!isFlickering && teleportTimer >= TELEPORT_INTERVAL - FLICKER_DURATION) {
-        isFlickering = true;
-        flickerTimer = 0.0f;
-    }
-
-    // Handle flickering effect
-    if (isFlickering) {
-        flickerTimer += deltaTime;
-
-        // Toggle visibility rapidly (15 times per second)
-        sf::Color color = sprite.getColor();
-        if (static_cast<int>(flickerTimer * 15) % 2 == 0) {
-            color.a = 255;  // Fully visible
-        }
-        else {
-            color.a = 100;  // Semi-transparent
-        }
-        setColor(color);
-
-        // Check if flickering period is over and we need to teleport
-        if (teleportTimer >= TELEPORT_INTERVAL) {
-            teleport();
-            isFlickering = false;
-            teleportTimer = 0.0f;
-
-            // Reset color to fully visible after teleport
-            sf::Color fullColor = sprite.getColor();
-            fullColor.a = 255;
-            setColor(fullColor);
-        }
-    }
-}
-
-void teleport() {
-    // Choose a random location from predefined teleport points
-    int randomIndex = std::rand() % teleportLocations.size();
-    sf::Vector2f newPos = teleportLocations[randomIndex];
-
-    // Teleport the ghost
-    SetPosition(newPos.x, newPos.y);
-
-    // Create a teleport effect (optional)
-    // You could add particle effects or sound here
-}
-
-bool isTeleportValid(const sf::Vector2f& position, Maze& maze) const {
-    // Check if the position is walkable in the maze
-    // This method can be used to verify teleport positions
-    return maze.isWalkable(position);
-}
-
-// Add a method to dynamically find valid teleport positions from the maze
-void updateTeleportLocations(Maze& maze) {
-    teleportLocations.clear();
-
-    // Scan the maze for walkable areas and add them as potential teleport locations
-    // This is an alternative to hardcoded positions
-    for (int y = 1; y < maze.getHeight() - 1; y += 4) {  // Skip every few rows for diversity
-        for (int x = 1; x < maze.getWidth() - 1; x += 4) { // Skip every few columns
-            sf::Vector2f pos(x * CELL_SIZE + CELL_SIZE / 2, y * CELL_SIZE + CELL_SIZE / 2);
-            if (maze.isWalkable(pos)) {
-                teleportLocations.push_back(pos);
-
-                // Limit to 8 positions maximum
-                if (teleportLocations.size() >= 8) {
-                    return;
-                }
-            }
-        }
-    }
-
-    // Fallback if we found fewer than 8 positions
-    if (teleportLocations.empty()) {
-        // Add a default position as fallback
-        teleportLocations.push_back(sf::Vector2f(180.f, 180.f));
-    }
-}
-
-void Reset() override {
-    Ghost::Reset();
-    teleportTimer = 0.0f;
-    isFlickering = false;
-    flickerTimer = 0.0f;
-
-    // Ensure full visibility
-    sf::Color color = sprite.getColor();
-    color.a = 255;
-    setColor(color);
-}
-
-// The following methods are inherited and used as-is:
-// updateAutonomous, GhostCollision, etc.
-
-// Optional: make the teleporter ghost move more aggressively
-void updateAutonomous(Maze& maze) override {
-    float deltaTime = 1.0f / 60.0f;
-
-    // Try to move in current direction
-    if (!Move(currentDirection, maze)) {
-        // If blocked, pick a new valid direction (excluding opposite)
-        std::vector<Direction> possibleDirs;
-
-        for (int d = 0; d < 4; ++d) {
-            Direction dir = static_cast<Direction>(d);
-            if (dir == getOpposite(currentDirection)) continue;
-
-            if (isValidDirection(maze, dir)) {
-                possibleDirs.push_back(dir);
-            }
-        }
-
-        if (!possibleDirs.empty()) {
-            currentDirection = possibleDirs[std::rand() % possibleDirs.size()];
-            Move(currentDirection, maze);  // Try the new direction immediately
-        }
-    }
-
-    Update(deltaTime);
-}
-};
-
-class PhantomGhost : public Ghost
-{
-    float EXTENDED_RADIUS;
-public:
-    PhantomGhost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes), EXTENDED_RADIUS(2.0f) {
-    }
-        bool GhostCollision(const sf::Vector2f& pacmanPosition) const override {
-        // Create larger bounds for collision detection
-        sf::FloatRect pacmanBounds(
-            pacmanPosition.x - 20.f * EXTENDED_RADIUS,
-            pacmanPosition.y - 20.f * EXTENDED_RADIUS,
-            40.f * EXTENDED_RADIUS,
-            40.f * EXTENDED_RADIUS
-        );
-
-        return getSprite().getGlobalBounds().intersects(pacmanBounds);
-    }
-};
-
-class AmbusherGhost : public Ghost {
-private:
-    bool isPaused;
-    float pauseTimer;
-    const float PAUSE_DURATION = 3.0f;  // 2 seconds pause on 'o' tiles
-
-    // Hardcoded 'o' positions from the map (in grid coordinates)
-    std::vector<sf::Vector2i> pausePositions;
-
-    // Maze offset
-    sf::Vector2f mazeOffset;
-
-    // Flag to ensure we only pause once on each 'o' tile
-    sf::Vector2i lastPauseTile;
-    bool hasPausedOnCurrentTile;
-
-public:
-    AmbusherGhost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
-        isPaused(false),
-        pauseTimer(0.0f),
-        mazeOffset(60.f, 40.f),  // Setting the maze offset
-        lastPauseTile(-1, -1),
-        hasPausedOnCurrentTile(false)
-    {
-        // Initialize the hardcoded 'o' positions from the map data
-        // Format is {x, y} in grid coordinates (not pixels)
-        pausePositions = {
-            {2, 2},    // Top left o
-            {17, 2},   // Top right o
-            {2, 15},   // Bottom left o
-            {17, 15}   // Bottom right o
-        };
-    }
-
-    void Update(float deltaTime) override {
-        // Call the base class animation update
-        Ghost::Update(deltaTime);
-
-        // If paused, update the timer
-        if (isPaused) {
-            pauseTimer += deltaTime;
-
-            // Resume movement if pause duration has elapsed
-            if (pauseTimer >= PAUSE_DURATION) {
-                isPaused = false;
-                pauseTimer = 0.0f;
-
-                // Force a small movement to ensure we break out of the pause state
-                // Move slightly in current direction
-                switch (GetCurrentDirection()) {
-                case UP:    position.y -= 2.0f; break;
-                case DOWN:  position.y += 2.0f; break;
-                case LEFT:  position.x -= 2.0f; break;
-                case RIGHT: position.x += 2.0f; break;
-                }
-                sprite.setPosition(position);
-
-                // Print debug info
-                std::cout << "Ghost resumed movement at position: ("
-                    << position.x << ", " << position.y << ")" << std::endl;
-            }
-        }
-    }
-
-    void updateAutonomous(Maze& maze) override {
-        // If paused, just update the timer but don't move
-        if (isPaused) {
-            Update(1.0f / 60.0f);
-            return;
-        }
-
-        // Get current cell position, accounting for maze offset
-        int cellX = static_cast<int>((position.x - mazeOffset.x) / CELL_SIZE);
-        int cellY = static_cast<int>((position.y - mazeOffset.y) / CELL_SIZE);
-
-        // If we've moved to a different cell, reset the pause flag for this cell
-        if (cellX != lastPauseTile.x || cellY != lastPauseTile.y) {
-            hasPausedOnCurrentTile = false;
-        }
-
-        // Calculate center of cell in pixel coordinates, accounting for maze offset
-        float centerX = (cellX * CELL_SIZE) + (CELL_SIZE / 2) + mazeOffset.x;
-        float centerY = (cellY * CELL_SIZE) + (CELL_SIZE / 2) + mazeOffset.y;
-
-        // Calculate distance from cell center
-        float distFromCenterX = std::abs(position.x - centerX);
-        float distFromCenterY = std::abs(position.y - centerY);
-
-        // If we're close to the center of a cell and haven't paused here yet, check if it's a pause position
-        if (!hasPausedOnCurrentTile && distFromCenterX < 5.0f && distFromCenterY < 5.0f) {
-            // Check if the current cell is in our list of pause positions
-            for (const auto& pos : pausePositions) {
-                if (pos.x == cellX && pos.y == cellY) {
-                    // Pause the ghost
-                    isPaused = true;
-                    pauseTimer = 0.0f;
-                    // Center the ghost precisely on the 'o' tile
-                    position.x = centerX;
-                    position.y = centerY;
-                    sprite.setPosition(position);
-
-                    // Mark that we've paused on this tile to prevent repeated pausing
-                    lastPauseTile = sf::Vector2i(cellX, cellY);
-                    hasPausedOnCurrentTile = true;
-
-                    // Print debug info
-                    std::cout << "Ghost paused at position: ("
-                        << position.x << ", " << position.y
-                        << "), cell: (" << cellX << ", " << cellY << ")" << std::endl;
-                    return;
-                }
-            }
-        }
-
-        // Regular movement logic from Ghost class
-        Ghost::updateAutonomous(maze);
-    }
-
-    bool isPauseActive() const {
-        return isPaused;
-    }
-
-    void Reset() override {
-        Ghost::Reset();
-        isPaused = false;
-        pauseTimer = 0.0f;
-        lastPauseTile = sf::Vector2i(-1, -1);
-        hasPausedOnCurrentTile = false;
-    }
-};
-
-
-class TimeStopGhost : public Ghost {
-private:
-    // Constants for time stop ability
-    const float TIME_STOP_COOLDOWN = 30.0f;    // Seconds between ability uses
-    const float TIME_STOP_DURATION = 3.0f;     // How long Pacman is stopped
-    const float WARNING_DURATION = 2.0f;       // Duration of warning flicker before ability activates
-
-    // Timers
-    float abilityTimer;                        // Tracks cooldown for time stop ability
-    float stopDurationTimer;                   // Tracks how long Pacman has been stopped
-
-    // State flags
-    bool isWarning;                            // True when the ghost is about to use its ability
-    bool isTimeStopActive;                     // True when time stop is currently active
-    float warningBlinkTimer;                   // For flicker effect during warning
-    const float BLINK_SPEED = 0.1f;            // How fast the ghost blinks during warning (seconds)
-
-    // Original color for restoration
-    sf::Color abilityColor;                    // Color when ability is active
-
-    // Reference to pacman (optional, can be passed to update method instead)
-    Pacman* targetPacman;
-
-public:
-    TimeStopGhost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
-        abilityTimer(0.0f),
-        stopDurationTimer(0.0f),
-        isWarning(false),
-        isTimeStopActive(false),
-        warningBlinkTimer(0.0f),
-        targetPacman(nullptr)
-    {
-        // Initialize ability color (light blue for time theme)
-        abilityColor = sf::Color(100, 200, 255);
-    }
-
-    // Set the target Pacman
-    void SetTarget(Pacman* pacman) {
-        targetPacman = pacman;
-    }
-
-    void Update(float deltaTime) override {
-        // Call the parent update method first
-        Ghost::Update(deltaTime);
-
-        // Update ability timer
-        abilityTimer += deltaTime;
-
-        // Check if warning phase should start
-        if (!isWarning && !isTimeStopActive && abilityTimer >= TIME_STOP_COOLDOWN - WARNING_DURATION) {
-            isWarning = true;
-            warningBlinkTimer = 0.0f;
-        }
-
-        // Handle warning flicker effect
-        if (isWarning) {
-            warningBlinkTimer += deltaTime;
-
-            // Flicker between original color and ability color (faster as time approaches)
-            float blinkFrequency = BLINK_SPEED * (1.0f - ((TIME_STOP_COOLDOWN - abilityTimer) / WARNING_DURATION));
-            blinkFrequency = std::max(blinkFrequency, BLINK_SPEED); // Don't go slower than minimum speed
-
-            if (static_cast<int>(warningBlinkTimer / blinkFrequency) % 2 == 0) {
-                setColor(originalColor);
-            }
-            else {
-                setColor(abilityColor);
-            }
-
-            // Check if it's time to activate ability
-            if (abilityTimer >= TIME_STOP_COOLDOWN) {
-                ActivateTimeStop();
-            }
-        }
-
-        // Handle active time stop
-        if (isTimeStopActive) {
-            stopDurationTimer += deltaTime;
-
-            // Make sure Pacman remains stopped if we have a reference to him
-            if (targetPacman != nullptr) {
-                // Use Pacman's Stop method with his current direction
-                targetPacman->Stop(targetPacman->GetDirection());
-            }
-
-            // End the time stop when duration is over
-            if (stopDurationTimer >= TIME_STOP_DURATION) {
-                DeactivateTimeStop();
-            }
-        }
-    }
-
-    // Alternative Update method that takes a Pacman reference directly
-    void Update(float deltaTime, Pacman& pacman) {
-        // Store temporary reference for this frame
-        targetPacman = &pacman;
-        Update(deltaTime);
-    }
-
-    // Method to activate the time stop ability
-    void ActivateTimeStop() {
-        isWarning = false;
-        isTimeStopActive = true;
-        stopDurationTimer = 0.0f;
-        setColor(abilityColor);
-
-        // Visual effect - ghost glows with time energy
-        sprite.setColor(sf::Color(abilityColor.r, abilityColor.g, abilityColor.b, 255));
-    }
-
-    // Method to deactivate the time stop
-    void DeactivateTimeStop() {
-        isTimeStopActive = false;
-        abilityTimer = 0.0f; // Reset the cooldown
-        setColor(originalColor);
-    }
-
-    // Check if time stop is currently active
-    bool IsTimeStopActive() const {
-        return isTimeStopActive;
-    }
-
-    // Override collision to handle Pacman stopping on contact
-    bool GhostCollision(const sf::Vector2f& pacmanPosition) const override {
-        bool collision = Ghost::GhostCollision(pacmanPosition);
-
-        // If we're colliding and the time stop isn't already active,
-        // we could potentially trigger the ability immediately
-        // (leaving this commented out as it depends on your game design)
-        /*
-        if (collision && !isTimeStopActive && !isWarning && abilityTimer > TIME_STOP_COOLDOWN * 0.5f) {
-            // Could force ability to activate early on collision
-            // const_cast<TimeStopGhost*>(this)->ActivateTimeStop();
-        }
-        */
-
-        return collision;
-    }
-
-    void Reset() override {
-        Ghost::Reset();
-        abilityTimer = 0.0f;
-        stopDurationTimer = 0.0f;
-        isWarning = false;
-        isTimeStopActive = false;
-        warningBlinkTimer = 0.0f;
-        // Don't need to reset targetPacman as it's a reference
-    }
-
-    // Float representing progress toward ability activation (0.0 to 1.0)
-    float GetAbilityProgress() const {
-        return abilityTimer / TIME_STOP_COOLDOWN;
-    }
-
-    // Forces the ability to activate immediately (for testing or special events)
-    void ForceActivate() {
-        abilityTimer = TIME_STOP_COOLDOWN;
-        isWarning = false;
-        ActivateTimeStop();
-    }
-};
-
-class ChaserGhost : public Ghost {
-private:
-    float rageTriggerTimer;
-    float rageDurationTimer;
-    bool isRaging;
-
-    const float RAGE_TRIGGER_TIME = 20.0f;
-    const float RAGE_DURATION = 2.0f;
-
-public:
-    ChaserGhost(const std::string& spriteSheetPath,
-        int frameCount, int frameWidth, int frameHeight,
-        float x, float y, float speed, float scale,
-        const std::map<Direction, int>& frameIndexes)
-        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
-        rageTriggerTimer(0.0f),
-        rageDurationTimer(0.0f),
-        isRaging(false)
-    {
-        // Ensure the original speed and color are stored
-        setSpeed(speed); // Initializes current speed
-    }
-
-    void Update(float deltaTime) override {
-        Ghost::Update(deltaTime);
-        rageTriggerTimer += deltaTime;
-
-        if (!isRaging && rageTriggerTimer >= RAGE_TRIGGER_TIME) {
-            isRaging = true;
-            rageDurationTimer = 0.0f;
-            setSpeed(getOriginalSpeed() * 3.0f);
-            setColor(sf::Color(255, 60, 60)); // Rage tint
-        }
-
-        if (isRaging) {
-            rageDurationTimer += deltaTime;
-            if (rageDurationTimer >= RAGE_DURATION) {
-                isRaging = false;
-                rageTriggerTimer = 0.0f;
-                setSpeed(speed/3.0f);             // Reset speed
-                setColor(getOriginalColor());             // Reset color
-            }
-        }
-    }
-
-    void Reset() override {
-        Ghost::Reset();
-        rageTriggerTimer = 0.0f;
-        rageDurationTimer = 0.0f;
-        isRaging = false;
-        setSpeed(speed/3.0f);
-        setColor(getOriginalColor());
-    }
-
-    bool getIsRaging() const { return isRaging; }
+﻿#pragma once
+#include "entity.h"
+#include "animation.h"
+#include "maze.h"
+#include "gamestate.h"
+#include "logger.h"
+#include "renderqueue.h"
+#include "behaviour.h"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+
+class Ghost : public Entity {
+protected:
+    Animation animation;
+    Direction currentDirection;
+    sf::Vector2f initialPosition;
+    int frameWidth, frameHeight;
+    float behaviorTimer;     // Timer for ghost behaviors
+    bool isScattered;        // For alternating between scatter and random movement
+    float scatterTimer;      // For timing scatter/random phases
+    const float SCATTER_DURATION = 7.0f;  // Seconds in scatter mode
+    sf::Color originalColor; // Store the original color for restoration after super mode
+    uint32_t randomState = 1; // see reseed()
+    BehaviourRunner behaviour; // the subclass's timed script, runs in Update (see behaviour.h)
+
+    // Where the ghost really is, in fixed point (see fixedpoint.h). Entity's
+    // float position follows it through place() and is only read.
+    FixedPos fixedPosition;
+    int32_t speedUnits = 0;        // per tick, in fixed point; Entity's speed follows it (setSpeedUnits)
+    int32_t spriteWidthUnits = 0;  // for the side wrap, ghosts never change size
+    bool jumped = false;           // placed rather than walked since clearJumped() (see sweptCollision)
+
+    // Constants for cell-based movement
+    static const int CELL_SIZE = 40;
+    static const int32_t CELL_UNITS = CELL_SIZE * FixedPos::ONE;
+    static const int32_t SWEEP_PIECE = 16 * FixedPos::ONE;   // under half the smallest hit box
+
+    void place(FixedPos pos) {
+        fixedPosition = pos;
+        position = pos.toPixels();
+        sprite.setPosition(position);
+    }
+
+    // pos moved units along dir
+    static FixedPos moveAlong(FixedPos pos, Direction dir, int32_t units) {
+        switch (dir) {
+        case RIGHT: pos.x += units; break;
+        case LEFT:  pos.x -= units; break;
+        case UP:    pos.y -= units; break;
+        case DOWN:  pos.y += units; break;
+        }
+        return pos;
+    }
+
+public:
+    Ghost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Entity(x, y, speed),
+        animation(0.1f),
+        currentDirection(LEFT),
+        initialPosition(x, y),
+        frameWidth(frameWidth),
+        frameHeight(frameHeight),
+        behaviorTimer(0.0f),
+        isScattered(true),
+        scatterTimer(0.0f)
+    {
+        // All ghost sheets share one atlas texture so ghosts batch into one draw
+        sf::IntRect sheet;
+        if (!headless()) {
+            sheet = atlas().add(spriteSheetPath);
+            if (sheet.width == 0) {
+                LOG_ERROR(LOG_GHOST, "Failed to load ghost texture: %s", spriteSheetPath.c_str());
+            }
+        }
+
+        sprite.setTexture(atlas().getTexture());
+        sprite.setTextureRect(sf::IntRect(sheet.left, sheet.top, frameWidth, frameHeight));
+        sprite.setScale(scale, scale);
+        spriteWidthUnits = FixedPos::fromPixels(sprite.getGlobalBounds().width);
+        setSpeed(speed);
+        place(FixedPos::fromPixels(position));
+        originalColor = sprite.getColor(); // Store the original color
+
+        for (int i = 0; i < frameCount; ++i) {
+            animation.addFrame(sf::IntRect(sheet.left + i * frameWidth, sheet.top, frameWidth, frameHeight)); // horizontal layout
+        }
+
+        std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    }
+
+    // Set by tools that run the simulation without a window (bench_replay),
+    // ghosts then skip loading their sprite sheet
+    static bool& headless() {
+        static bool value = false;
+        return value;
+    }
+
+    static TextureAtlas& atlas() {
+        static TextureAtlas sheets;
+        return sheets;
+    }
+
+    // Ghosts roll their own numbers instead of sharing rand(). GameWorld reseeds
+    // every ghost every tick, so its choices don't depend on which thread ran
+    // it or what the other ghosts rolled (see jobs.h).
+    void reseed(uint32_t seed) {
+        seed ^= seed >> 16;
+        seed *= 0x7feb352du;
+        seed ^= seed >> 15;
+        seed *= 0x846ca68bu;
+        seed ^= seed >> 16;
+        randomState = seed ? seed : 1;
+    }
+
+    uint32_t nextRandom() {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState;
+    }
+
+    // Speeds are given in pixels per tick and kept in fixed point, so every
+    // change to them (super speed, rage) is exact integer arithmetic
+    void setSpeed(float newSpeed) { setSpeedUnits(FixedPos::fromPixels(newSpeed)); }
+    void setSpeedUnits(int32_t units) {
+        speedUnits = units;
+        speed = FixedPos::toPixels(units);
+    }
+    int32_t getSpeedUnits() const { return speedUnits; }
+    float getOriginalSpeed() const { return speed; }
+    virtual ~Ghost() = default;
+
+    virtual bool Move(Direction dir, const Maze& maze) {
+        FixedPos tempPosition = moveAlong(fixedPosition, dir, speedUnits);
+
+        // Off one side comes back on the other
+        int32_t mazeLeft = maze.getOrigin().x;
+        int32_t mazeRight = maze.getWidth() * Maze::getCellUnits() + mazeLeft;
+        int32_t spriteWidth = spriteWidthUnits;
+        int32_t margin = 10 * FixedPos::ONE;
+        bool wrapped = true;
+        if (tempPosition.x < mazeLeft) {
+            tempPosition.x = mazeRight - spriteWidth - margin;
+        }
+        else if (tempPosition.x + spriteWidth > mazeRight - margin) {
+            tempPosition.x = mazeLeft + margin;
+        }
+        else {
+            wrapped = false;
+        }
+
+        if (isValidDirection(maze, dir)) {
+            place(tempPosition);
+            jumped = jumped || wrapped;
+            currentDirection = dir;
+            return true;  // Move succeeded
+        }
+
+        return false;  // Blocked by wall
+    }
+
+    void menMove(Direction dir) {
+        currentDirection = dir;
+        place(moveAlong(fixedPosition, dir, speedUnits));
+        Update(1.0f / 60.0f);
+    }
+
+    virtual void Update(float deltaTime) {
+        animation.updateGhost(currentDirection, sprite);
+        behaviour.advance(deltaTime);
+    }
+
+    virtual void Reset() {
+        place(FixedPos::fromPixels(initialPosition));
+        jumped = true;
+        currentDirection = LEFT;
+        isScattered = true;
+        scatterTimer = 0.0f;
+        behaviorTimer = 0.0f;
+        animation.reset();
+        sprite.setColor(originalColor); // Reset to original color
+    }
+
+    sf::Vector2f GetPosition() const {
+        return position;
+    }
+
+    // Puts the ghost somewhere (a teleport, a respawn): a jump, not a step
+    void SetPosition(float x, float y) {
+        place(FixedPos::fromPixels(sf::Vector2f(x, y)));
+        jumped = true;
+    }
+
+    bool hasJumped() const { return jumped; }
+    void clearJumped() { jumped = false; }
+
+    FixedPos GetFixedPosition() const {
+        return fixedPosition;
+    }
+
+    virtual const sf::Sprite& getSprite() const {
+        return sprite;
+    }
+
+    virtual bool GhostCollision(const sf::Vector2f& pacmanPosition) const {
+        sf::FloatRect pacmanBounds(
+            pacmanPosition.x - 20.f, // center the 40x40 box around pacmanPosition
+            pacmanPosition.y - 20.f,
+            40.f,
+            40.f
+        );
+
+        return sprite.getGlobalBounds().intersects(pacmanBounds);
+    }
+
+    // When during a step Pacman first touches the ghost: how far along the
+    // step, 0 to Maze::SWEEP_END, or -1 if he doesn't. Both went in a straight
+    // line, the ghost from ghostFrom to where it is now. Touching only depends
+    // on where Pacman is relative to the ghost, so the ghost stays put and
+    // Pacman moves by the difference of the two steps, in pieces shorter than
+    // any hit box. Nobody passes through anybody, however fast.
+    //
+    // A jump isn't a line. If the ghost jumped since clearJumped() (tunnel,
+    // teleport, respawn), or pacmanJumped, that side only counts where it
+    // landed.
+    int32_t sweptCollision(FixedPos ghostFrom, FixedPos pacmanFrom, FixedPos pacmanTo, bool pacmanJumped) const {
+        if (jumped) ghostFrom = fixedPosition;
+        if (pacmanJumped) pacmanFrom = pacmanTo;
+
+        FixedPos start(pacmanFrom.x + fixedPosition.x - ghostFrom.x, pacmanFrom.y + fixedPosition.y - ghostFrom.y);
+        int64_t dx = pacmanTo.x - start.x;
+        int64_t dy = pacmanTo.y - start.y;
+        int64_t pieces = std::max<int64_t>(1, (std::max(std::abs(dx), std::abs(dy)) + SWEEP_PIECE - 1) / SWEEP_PIECE);
+        for (int64_t k = 0; k <= pieces; ++k) {
+            FixedPos relative(start.x + static_cast<int32_t>(dx * k / pieces), start.y + static_cast<int32_t>(dy * k / pieces));
+            if (GhostCollision(relative.toPixels())) {
+                return static_cast<int32_t>(k * Maze::SWEEP_END / pieces);
+            }
+        }
+        return -1;
+    }
+
+    virtual void updateAutonomous(const Maze& maze) {
+        float deltaTime = 1.0f / 60.0f;
+
+        // Try to move in current direction
+        if (!Move(currentDirection, maze)) {
+            // If blocked, pick a new valid direction (excluding opposite)
+            std::vector<Direction> possibleDirs;
+
+            for (int d = 0; d < 4; ++d) {
+                Direction dir = static_cast<Direction>(d);
+                if (dir == getOpposite(currentDirection)) continue;
+
+                if (isValidDirection(maze, dir)) {
+                    possibleDirs.push_back(dir);
+                }
+            }
+
+            if (!possibleDirs.empty()) {
+                currentDirection = possibleDirs[nextRandom() % possibleDirs.size()];
+                Move(currentDirection, maze);  // Try the new direction immediately
+            }
+        }
+
+        Update(deltaTime);
+    }
+
+    // One step along the current direction and nothing else, for the ticks the
+    // AI LOD scheduler (ailod.h) skips. False if the ghost is blocked and has
+    // to pick a direction, which takes a full update.
+    virtual bool extrapolate(const Maze& maze) {
+        return Move(currentDirection, maze);
+    }
+
+    Direction GetCurrentDirection() const {
+        return currentDirection;
+    }
+
+    std::vector<Direction> getAvailableDirections(const Maze& maze) {
+        std::vector<Direction> dirs;
+
+        // Try each direction, excluding the opposite of current direction
+        for (int d = 0; d < 4; ++d) {
+            Direction dir = static_cast<Direction>(d);
+
+            // Skip the opposite direction (no backtracking)
+            if (dir == getOpposite(currentDirection)) {
+                continue;
+            }
+
+            // Check the position a cell away in each direction
+            FixedPos testPos = moveAlong(fixedPosition, dir, CELL_UNITS);
+
+            // If the new position is walkable, add this direction to the list
+            if (maze.isWalkable(testPos)) {
+                dirs.push_back(dir);
+            }
+        }
+
+        // If no directions are valid (i.e., dead-end), go back
+        if (dirs.empty()) {
+            dirs.push_back(getOpposite(currentDirection));
+        }
+
+        return dirs;
+    }
+
+    Direction getOpposite(Direction dir) const {
+        switch (dir) {
+        case UP: return DOWN;
+        case DOWN: return UP;
+        case LEFT: return RIGHT;
+        case RIGHT: return LEFT;
+        default: return LEFT;
+        }
+    }
+
+    bool isAwayFromCenterEnough() const {
+        int32_t minDistance = 25 * FixedPos::ONE;  // Ghost must be at least this far from cell center
+
+        int32_t centerX = floorDiv(fixedPosition.x + CELL_UNITS / 2, CELL_UNITS) * CELL_UNITS + CELL_UNITS / 2;
+        int32_t centerY = floorDiv(fixedPosition.y + CELL_UNITS / 2, CELL_UNITS) * CELL_UNITS + CELL_UNITS / 2;
+
+        int32_t dx = std::abs(fixedPosition.x - centerX);
+        int32_t dy = std::abs(fixedPosition.y - centerY);
+
+        return dx > minDistance || dy > minDistance;
+    }
+
+    bool isValidDirection(const Maze& maze, Direction dir) {
+        // Round to center of current cell
+        FixedPos testPos(
+            floorDiv(fixedPosition.x, CELL_UNITS) * CELL_UNITS + CELL_UNITS / 2,
+            floorDiv(fixedPosition.y, CELL_UNITS) * CELL_UNITS + CELL_UNITS / 2);
+
+        // Move one full cell in the given direction
+        return maze.isWalkable(moveAlong(testPos, dir, CELL_UNITS));
+    }
+
+    void SuperSpeed() {
+        setSpeedUnits(speedUnits + FixedPos::ONE);  // Increase speed
+    }
+
+    void ResetSpeed() {
+        setSpeedUnits(speedUnits - FixedPos::ONE);  // Reset speed
+    }
+
+    // Set the color of the ghost for super mode
+    void setColor(const sf::Color& color) {
+        sprite.setColor(color);
+    }
+
+    // Get the original color of the ghost
+    sf::Color getOriginalColor() const {
+        return originalColor;
+    }
+
+    virtual GhostKind kind() const { return GHOST_BASIC; }
+
+    // Copy the simulation side of the ghost into a plain-data snapshot (see gamestate.h).
+    // Subclasses call this first and then add their own timers and flags.
+    virtual void saveState(GhostState& state) const {
+        state.kind = kind();
+        state.x = position.x;
+        state.y = position.y;
+        state.speed = FixedPos::toPixels(speedUnits);
+        state.behaviorTimer = behaviorTimer;
+        state.scatterTimer = scatterTimer;
+        state.timers[0] = state.timers[1] = state.timers[2] = 0.0f;
+        state.tileX = state.tileY = -1;
+        state.flags = isScattered ? GF_SCATTERED : 0;
+        state.direction = static_cast<uint8_t>(currentDirection);
+        sf::Color color = sprite.getColor();
+        state.color[0] = color.r;
+        state.color[1] = color.g;
+        state.color[2] = color.b;
+        state.color[3] = color.a;
+    }
+
+    // Snapshots keep positions in pixels, which hold every fixed-point one exactly
+    virtual void loadState(const GhostState& state) {
+        place(FixedPos::fromPixels(sf::Vector2f(state.x, state.y)));
+        jumped = true;
+        setSpeed(state.speed);
+        behaviorTimer = state.behaviorTimer;
+        scatterTimer = state.scatterTimer;
+        isScattered = (state.flags & GF_SCATTERED) != 0;
+        currentDirection = static_cast<Direction>(state.direction);
+        sprite.setColor(sf::Color(state.color[0], state.color[1], state.color[2], state.color[3]));
+    }
+};
+
+class RingGhost : public Ghost {
+private:
+    const float INVISIBLE_DURATION = 3.0f;
+    const float VISIBLE_DURATION = 5.0f;
+    const float BLINK_WARNING_DURATION = 1.0f;  // Duration of blinking warning before state change
+    const float BLINK_INTERVAL = 0.1f;          // Toggle visibility 10 times per second
+    static const int BLINK_STEPS = 10;          // BLINK_WARNING_DURATION / BLINK_INTERVAL
+
+    // Kept up to date by script() for the getters and saveState
+    bool isVisible;
+    double phaseStart;       // when the ghost last appeared or vanished
+
+    float phaseDuration() const { return isVisible ? VISIBLE_DURATION : INVISIBLE_DURATION; }
+
+    // Visible and invisible in turn, blinking for the last second of each.
+    // elapsed is the time already spent in the current phase (loadState).
+    Behaviour script(float elapsed) {
+        for (double start = behaviour.now() - elapsed;; ) {
+            phaseStart = start;
+            double end = start + phaseDuration();
+            double blinkStart = end - BLINK_WARNING_DURATION;
+
+            for (int step = 0; step < BLINK_STEPS; ++step) {
+                co_await behaviour.until(blinkStart + step * BLINK_INTERVAL);
+                sf::Color color = sprite.getColor();
+                color.a = step % 2 == 0 ? 255 : 80;   // Fully visible / semi-transparent
+                setColor(color);
+            }
+
+            co_await behaviour.until(end);
+            isVisible = !isVisible;
+            updateVisibility();
+            start = end;
+        }
+    }
+
+public:
+    RingGhost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
+        isVisible(true),
+        phaseStart(0.0) {
+        updateVisibility();
+        behaviour.start(script(0.0f));
+    }
+
+    bool getIsVisible() const { return isVisible; }
+    float getVisibilityTimer() const { return static_cast<float>(behaviour.now() - phaseStart); }
+    bool getIsBlinking() const { return getVisibilityTimer() >= phaseDuration() - BLINK_WARNING_DURATION; }
+
+    void updateVisibility() {
+        sf::Color color = sprite.getColor();
+        color.a = isVisible ? 255 : 0; // Full opacity when visible, transparent when invisible
+        setColor(color);
+    }
+
+    // Override the getSprite method to control visibility
+    const sf::Sprite& getSprite() const override {
+        return Ghost::getSprite();
+    }
+
+    // RingGhost can still collide even when invisible
+    bool GhostCollision(const sf::Vector2f& pacmanPosition) const override {
+        // Ghost can collide even when invisible
+        return Ghost::GhostCollision(pacmanPosition);
+    }
+
+    void Reset() override {
+        Ghost::Reset();
+        isVisible = true;
+        updateVisibility();
+        behaviour.start(script(0.0f));
+    }
+
+    GhostKind kind() const override { return GHOST_RING; }
+
+    void saveState(GhostState& state) const override {
+        Ghost::saveState(state);
+        float visibilityTimer = getVisibilityTimer();
+        state.timers[0] = visibilityTimer;
+        state.timers[1] = std::max(0.0f, visibilityTimer - (phaseDuration() - BLINK_WARNING_DURATION));
+        if (isVisible) state.flags |= GF_VISIBLE;
+        if (getIsBlinking()) state.flags |= GF_BLINKING;
+    }
+
+    // The blink timer follows from the phase timer, the script picks up from there
+    void loadState(const GhostState& state) override {
+        Ghost::loadState(state);
+        isVisible = (state.flags & GF_VISIBLE) != 0;
+        behaviour.start(script(state.timers[0]));
+    }
+};
+
+class TeleporterGhost : public Ghost {
+private:
+    const float TELEPORT_INTERVAL = 10.0f;  // Seconds between teleports
+    const float FLICKER_DURATION = 2.0f;    // Duration of flickering before teleport
+    const float FLICKER_INTERVAL = 1.0f / 15.0f;  // Toggle visibility 15 times per second
+    static const int FLICKER_STEPS = 30;    // FLICKER_DURATION / FLICKER_INTERVAL
+    double cycleStart;              // When the current interval began, kept by script()
+    std::vector<sf::Vector2f> teleportLocations; // Predefined teleport locations
+
+    // Wander 8 s, flicker 2 s, teleport, and again. elapsed is the time already
+    // spent in the current interval (loadState).
+    Behaviour script(float elapsed) {
+        for (double start = behaviour.now() - elapsed;; start += TELEPORT_INTERVAL) {
+            cycleStart = start;
+            double flickerStart = start + TELEPORT_INTERVAL - FLICKER_DURATION;
+
+            for (int step = 0; step < FLICKER_STEPS; ++step) {
+                co_await behaviour.until(flickerStart + step * FLICKER_INTERVAL);
+                sf::Color color = sprite.getColor();
+                color.a = step % 2 == 0 ? 255 : 100;   // Fully visible / semi-transparent
+                setColor(color);
+            }
+
+            co_await behaviour.until(start + TELEPORT_INTERVAL);
+            teleport();
+
+            // Reset color to fully visible after teleport
+            sf::Color fullColor = sprite.getColor();
+            fullColor.a = 255;
+            setColor(fullColor);
+        }
+    }
+
+    float getTeleportTimer() const { return static_cast<float>(behaviour.now() - cycleStart); }
+
+public:
+    TeleporterGhost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
+        cycleStart(0.0)
+    {
+        // Initialize predefined teleport locations (adjust coordinates based on your maze)
+        initTeleportLocations();
+        behaviour.start(script(0.0f));
+    }
+
+    void initTeleportLocations() {
+        // Define 8 valid teleport locations based on the provided grid coordinates
+        // Converting grid positions to pixel positions with CELL_SIZE = 40
+        // For each grid position (x,y), calculate pixel position as (x*40 + offset.x, y*40 + offset.y)
+        // to place the ghost at the correct position accounting for maze offset
+
+        const sf::Vector2f offset(60.f, 40.f); // Maze offset
+
+        const std::vector<sf::Vector2i> TELEPORT_POINTS = {
+            {2, 1},   // Top-left corner
+            {17, 1},  // Top-right
+            {2, 15},  // Bottom-left
+            {17, 15}, // Bottom-right
+            {9, 4},   // Center-top
+            {9, 12},  // Center-bottom
+            {4, 9},   // Left-center
+            {14, 9}   // Right-center
+        };
+
+        teleportLocations.clear();
+        // Convert grid coordinates to pixel coordinates with offset
+        for (const auto& point : TELEPORT_POINTS) {
+            // Calculate center of the tile with offset
+            float x = point.x * CELL_SIZE + offset.x;
+            float y = point.y * CELL_SIZE + offset.y;
+            teleportLocations.push_back(sf::Vector2f(x, y));
+        }
+    }
+
+void teleport() {
+    // Choose a random location from predefined teleport points
+    int randomIndex = nextRandom() % teleportLocations.size();
+    sf::Vector2f newPos = teleportLocations[randomIndex];
+
+    // Teleport the ghost
+    SetPosition(newPos.x, newPos.y);
+
+    // Create a teleport effect (optional)
+    // You could add particle effects or sound here
+}
+
+bool isTeleportValid(const sf::Vector2f& position, const Maze& maze) const {
+    // Check if the position is walkable in the maze
+    // This method can be used to verify teleport positions
+    return maze.isWalkable(position);
+}
+
+// Add a method to dynamically find valid teleport positions from the maze
+void updateTeleportLocations(const Maze& maze) {
+    teleportLocations.clear();
+
+    // Scan the maze for walkable areas and add them as potential teleport locations
+    // This is an alternative to hardcoded positions
+    for (int y = 1; y < maze.getHeight() - 1; y += 4) {  // Skip every few rows for diversity
+        for (int x = 1; x < maze.getWidth() - 1; x += 4) { // Skip every few columns
+            sf::Vector2f pos(x * CELL_SIZE + CELL_SIZE / 2, y * CELL_SIZE + CELL_SIZE / 2);
+            if (maze.isWalkable(pos)) {
+                teleportLocations.push_back(pos);
+
+                // Limit to 8 positions maximum
+                if (teleportLocations.size() >= 8) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // Fallback if we found fewer than 8 positions
+    if (teleportLocations.empty()) {
+        // Add a default position as fallback
+        teleportLocations.push_back(sf::Vector2f(180.f, 180.f));
+    }
+}
+
+void Reset() override {
+    Ghost::Reset();
+
+    // Ensure full visibility
+    sf::Color color = sprite.getColor();
+    color.a = 255;
+    setColor(color);
+    behaviour.start(script(0.0f));
+}
+
+GhostKind kind() const override { return GHOST_TELEPORTER; }
+
+void saveState(GhostState& state) const override {
+    Ghost::saveState(state);
+    float teleportTimer = getTeleportTimer();
+    float flickerTimer = teleportTimer - (TELEPORT_INTERVAL - FLICKER_DURATION);
+    state.timers[0] = teleportTimer;
+    state.timers[1] = std::max(0.0f, flickerTimer);
+    if (flickerTimer >= 0.0f) state.flags |= GF_FLICKERING;
+}
+
+// The flicker follows from the teleport timer, the script picks up from there
+void loadState(const GhostState& state) override {
+    Ghost::loadState(state);
+    behaviour.start(script(state.timers[0]));
+}
+
+// The following methods are inherited and used as-is:
+// updateAutonomous, GhostCollision, etc.
+
+// Optional: make the teleporter ghost move more aggressively
+void updateAutonomous(const Maze& maze) override {
+    float deltaTime = 1.0f / 60.0f;
+
+    // Try to move in current direction
+    if (!Move(currentDirection, maze)) {
+        // If blocked, pick a new valid direction (excluding opposite)
+        std::vector<Direction> possibleDirs;
+
+        for (int d = 0; d < 4; ++d) {
+            Direction dir = static_cast<Direction>(d);
+            if (dir == getOpposite(currentDirection)) continue;
+
+            if (isValidDirection(maze, dir)) {
+                possibleDirs.push_back(dir);
+            }
+        }
+
+        if (!possibleDirs.empty()) {
+            currentDirection = possibleDirs[nextRandom() % possibleDirs.size()];
+            Move(currentDirection, maze);  // Try the new direction immediately
+        }
+    }
+
+    Update(deltaTime);
+}
+};
+
+class PhantomGhost : public Ghost
+{
+    float EXTENDED_RADIUS;
+public:
+    PhantomGhost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes), EXTENDED_RADIUS(2.0f) {
+    }
+        bool GhostCollision(const sf::Vector2f& pacmanPosition) const override {
+        // Create larger bounds for collision detection
+        sf::FloatRect pacmanBounds(
+            pacmanPosition.x - 20.f * EXTENDED_RADIUS,
+            pacmanPosition.y - 20.f * EXTENDED_RADIUS,
+            40.f * EXTENDED_RADIUS,
+            40.f * EXTENDED_RADIUS
+        );
+
+        return getSprite().getGlobalBounds().intersects(pacmanBounds);
+    }
+
+    GhostKind kind() const override { return GHOST_PHANTOM; }
+};
+
+class AmbusherGhost : public Ghost {
+private:
+    const float PAUSE_DURATION = 3.0f;  // 2 seconds pause on 'o' tiles
+
+    // Kept up to date by script()
+    bool isPaused;
+    double pauseStart;
+
+    // Hardcoded 'o' positions from the map (in grid coordinates)
+    std::vector<sf::Vector2i> pausePositions;
+
+    // Maze offset
+    FixedPos mazeOffset;
+
+    // Flag to ensure we only pause once on each 'o' tile
+    sf::Vector2i lastPauseTile;
+    bool hasPausedOnCurrentTile;
+
+    // Waits for updateAutonomous to stop it on an 'o' tile, holds still for
+    // PAUSE_DURATION and moves on. pausedFor is the time already paused
+    // (loadState), negative when it isn't.
+    Behaviour script(float pausedFor) {
+        for (;; pausedFor = -1.0f) {
+            if (pausedFor < 0.0f) {
+                co_await behaviour.signalled();
+                pausedFor = 0.0f;
+            }
+            isPaused = true;
+            pauseStart = behaviour.now() - pausedFor;
+            co_await behaviour.until(pauseStart + PAUSE_DURATION);
+            isPaused = false;
+
+            // Force a small movement to ensure we break out of the pause state
+            // Move slightly in current direction
+            place(moveAlong(fixedPosition, GetCurrentDirection(), 2 * FixedPos::ONE));
+
+            // Print debug info
+            LOG_DEBUG(LOG_GHOST, "Ghost resumed movement at position: (%.1f, %.1f)", position.x, position.y);
+        }
+    }
+
+public:
+    AmbusherGhost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
+        isPaused(false),
+        pauseStart(0.0),
+        mazeOffset(60 * FixedPos::ONE, 40 * FixedPos::ONE),  // Setting the maze offset
+        lastPauseTile(-1, -1),
+        hasPausedOnCurrentTile(false)
+    {
+        // Initialize the hardcoded 'o' positions from the map data
+        // Format is {x, y} in grid coordinates (not pixels)
+        pausePositions = {
+            {2, 2},    // Top left o
+            {17, 2},   // Top right o
+            {2, 15},   // Bottom left o
+            {17, 15}   // Bottom right o
+        };
+        behaviour.start(script(-1.0f));
+    }
+
+    void updateAutonomous(const Maze& maze) override {
+        // If paused, just update the timer but don't move
+        if (isPaused) {
+            Update(1.0f / 60.0f);
+            return;
+        }
+
+        // Get current cell position, accounting for maze offset
+        int cellX = floorDiv(fixedPosition.x - mazeOffset.x, CELL_UNITS);
+        int cellY = floorDiv(fixedPosition.y - mazeOffset.y, CELL_UNITS);
+
+        // If we've moved to a different cell, reset the pause flag for this cell
+        if (cellX != lastPauseTile.x || cellY != lastPauseTile.y) {
+            hasPausedOnCurrentTile = false;
+        }
+
+        // Calculate center of cell, accounting for maze offset
+        FixedPos center(
+            cellX * CELL_UNITS + CELL_UNITS / 2 + mazeOffset.x,
+            cellY * CELL_UNITS + CELL_UNITS / 2 + mazeOffset.y);
+
+        // Calculate distance from cell center
+        int32_t distFromCenterX = std::abs(fixedPosition.x - center.x);
+        int32_t distFromCenterY = std::abs(fixedPosition.y - center.y);
+
+        // If we're close to the center of a cell and haven't paused here yet, check if it's a pause position
+        int32_t nearCenter = 5 * FixedPos::ONE;
+        if (!hasPausedOnCurrentTile && distFromCenterX < nearCenter && distFromCenterY < nearCenter) {
+            // Check if the current cell is in our list of pause positions
+            for (const auto& pos : pausePositions) {
+                if (pos.x == cellX && pos.y == cellY) {
+                    // Center the ghost precisely on the 'o' tile
+                    place(center);
+
+                    // Mark that we've paused on this tile to prevent repeated pausing
+                    lastPauseTile = sf::Vector2i(cellX, cellY);
+                    hasPausedOnCurrentTile = true;
+
+                    // Pause the ghost
+                    behaviour.signal();
+
+                    // Print debug info
+                    LOG_DEBUG(LOG_GHOST, "Ghost paused at position: (%.1f, %.1f), cell: (%d, %d)",
+                        position.x, position.y, cellX, cellY);
+                    return;
+                }
+            }
+        }
+
+        // Regular movement logic from Ghost class
+        Ghost::updateAutonomous(maze);
+    }
+
+    // Pausing (and the tile it pauses on) takes full updates
+    bool extrapolate(const Maze& maze) override {
+        if (isPaused) return false;
+        int cellX = floorDiv(fixedPosition.x - mazeOffset.x, CELL_UNITS);
+        int cellY = floorDiv(fixedPosition.y - mazeOffset.y, CELL_UNITS);
+        for (const auto& pos : pausePositions) {
+            if (pos.x == cellX && pos.y == cellY) return false;
+        }
+        return Ghost::extrapolate(maze);
+    }
+
+    bool isPauseActive() const {
+        return isPaused;
+    }
+
+    void Reset() override {
+        Ghost::Reset();
+        isPaused = false;
+        lastPauseTile = sf::Vector2i(-1, -1);
+        hasPausedOnCurrentTile = false;
+        behaviour.start(script(-1.0f));
+    }
+
+    GhostKind kind() const override { return GHOST_AMBUSHER; }
+
+    void saveState(GhostState& state) const override {
+        Ghost::saveState(state);
+        state.timers[0] = isPaused ? static_cast<float>(behaviour.now() - pauseStart) : 0.0f;
+        state.tileX = static_cast<int16_t>(lastPauseTile.x);
+        state.tileY = static_cast<int16_t>(lastPauseTile.y);
+        if (isPaused) state.flags |= GF_PAUSED;
+        if (hasPausedOnCurrentTile) state.flags |= GF_PAUSED_TILE;
+    }
+
+    void loadState(const GhostState& state) override {
+        Ghost::loadState(state);
+        lastPauseTile = sf::Vector2i(state.tileX, state.tileY);
+        hasPausedOnCurrentTile = (state.flags & GF_PAUSED_TILE) != 0;
+        isPaused = false;
+        behaviour.start(script((state.flags & GF_PAUSED) != 0 ? state.timers[0] : -1.0f));
+    }
+};
+
+
+class TimeStopGhost : public Ghost {
+private:
+    // Constants for time stop ability
+    const float TIME_STOP_COOLDOWN = 30.0f;    // Seconds between ability uses
+    const float TIME_STOP_DURATION = 3.0f;     // How long Pacman is stopped
+    const float WARNING_DURATION = 2.0f;       // Duration of warning flicker before ability activates
+    const float BLINK_SPEED = 0.1f;            // How fast the ghost blinks during warning (seconds)
+    static const int WARNING_STEPS = 20;       // WARNING_DURATION / BLINK_SPEED
+
+    double cycleStart;                         // When the current cooldown began, kept by script()
+
+    // Original color for restoration
+    sf::Color abilityColor;                    // Color when ability is active
+
+    // Reference to pacman (optional, can be passed to update method instead)
+    Pacman* targetPacman;
+
+    // Cool down, blink a warning for the last 2 s of it, stop time for 3 s, and
+    // again. elapsed is the time already spent in the current round (loadState).
+    Behaviour script(float elapsed) {
+        for (double start = behaviour.now() - elapsed;; start += TIME_STOP_COOLDOWN + TIME_STOP_DURATION) {
+            cycleStart = start;
+            double activateAt = start + TIME_STOP_COOLDOWN;
+            double warningStart = activateAt - WARNING_DURATION;
+
+            // Flicker between original color and ability color
+            for (int step = 0; step < WARNING_STEPS; ++step) {
+                co_await behaviour.until(warningStart + step * BLINK_SPEED);
+                setColor(step % 2 == 0 ? originalColor : abilityColor);
+            }
+
+            co_await behaviour.until(activateAt);
+            ActivateTimeStop();
+            co_await behaviour.until(activateAt + TIME_STOP_DURATION);
+            DeactivateTimeStop();
+        }
+    }
+
+    // Visual effect - ghost glows with time energy
+    void ActivateTimeStop() {
+        sprite.setColor(sf::Color(abilityColor.r, abilityColor.g, abilityColor.b, 255));
+    }
+
+    void DeactivateTimeStop() {
+        setColor(originalColor);
+    }
+
+    float getAbilityTimer() const { return static_cast<float>(behaviour.now() - cycleStart); }
+
+public:
+    TimeStopGhost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
+        cycleStart(0.0),
+        targetPacman(nullptr)
+    {
+        // Initialize ability color (light blue for time theme)
+        abilityColor = sf::Color(100, 200, 255);
+        behaviour.start(script(0.0f));
+    }
+
+    // Set the target Pacman
+    void SetTarget(Pacman* pacman) {
+        targetPacman = pacman;
+    }
+
+    void Update(float deltaTime) override {
+        // Call the parent update method first, it runs the script
+        Ghost::Update(deltaTime);
+
+        // Make sure Pacman remains stopped if we have a reference to him
+        if (targetPacman != nullptr && IsTimeStopActive()) {
+            // Use Pacman's Stop method with his current direction
+            targetPacman->Stop(targetPacman->GetDirection());
+        }
+    }
+
+    // Alternative Update method that takes a Pacman reference directly
+    void Update(float deltaTime, Pacman& pacman) {
+        // Store temporary reference for this frame
+        targetPacman = &pacman;
+        Update(deltaTime);
+    }
+
+    bool IsWarning() const {
+        float abilityTimer = getAbilityTimer();
+        return abilityTimer >= TIME_STOP_COOLDOWN - WARNING_DURATION && abilityTimer < TIME_STOP_COOLDOWN;
+    }
+
+    // Check if time stop is currently active
+    bool IsTimeStopActive() const {
+        return getAbilityTimer() >= TIME_STOP_COOLDOWN;
+    }
+
+    // Override collision to handle Pacman stopping on contact
+    bool GhostCollision(const sf::Vector2f& pacmanPosition) const override {
+        bool collision = Ghost::GhostCollision(pacmanPosition);
+
+        // If we're colliding and the time stop isn't already active,
+        // we could potentially trigger the ability immediately
+        // (leaving this commented out as it depends on your game design)
+        /*
+        if (collision && !IsTimeStopActive() && !IsWarning() && GetAbilityProgress() > 0.5f) {
+            // Could force ability to activate early on collision
+            // const_cast<TimeStopGhost*>(this)->ForceActivate();
+        }
+        */
+
+        return collision;
+    }
+
+    void Reset() override {
+        Ghost::Reset();
+        behaviour.start(script(0.0f));
+        // Don't need to reset targetPacman as it's a reference
+    }
+
+    // Float representing progress toward ability activation (0.0 to 1.0)
+    float GetAbilityProgress() const {
+        return std::min(1.0f, getAbilityTimer() / TIME_STOP_COOLDOWN);
+    }
+
+    // Forces the ability to activate immediately (for testing or special events)
+    void ForceActivate() {
+        behaviour.start(script(TIME_STOP_COOLDOWN));
+    }
+
+    GhostKind kind() const override { return GHOST_TIMESTOP; }
+
+    void saveState(GhostState& state) const override {
+        Ghost::saveState(state);
+        float abilityTimer = getAbilityTimer();
+        state.timers[0] = abilityTimer;
+        state.timers[1] = std::max(0.0f, abilityTimer - TIME_STOP_COOLDOWN);
+        state.timers[2] = std::max(0.0f, abilityTimer - (TIME_STOP_COOLDOWN - WARNING_DURATION));
+        if (IsWarning()) state.flags |= GF_WARNING;
+        if (IsTimeStopActive()) state.flags |= GF_TIMESTOP;
+    }
+
+    // Everything else follows from the ability timer, the script picks up from there
+    void loadState(const GhostState& state) override {
+        Ghost::loadState(state);
+        behaviour.start(script(state.timers[0]));
+    }
+};
+
+class ChaserGhost : public Ghost {
+private:
+    const float RAGE_TRIGGER_TIME = 20.0f;
+    const float RAGE_DURATION = 2.0f;
+
+    double cycleStart;       // When the current calm spell began, kept by script()
+
+    // Calm for 20 s, then rage for 2 s at triple speed, and again. elapsed is
+    // the time already spent in the current round (loadState); a rage that
+    // had already begun is in the loaded speed and color.
+    Behaviour script(float elapsed) {
+        for (double start = behaviour.now() - elapsed;; start += RAGE_TRIGGER_TIME + RAGE_DURATION, elapsed = 0.0f) {
+            cycleStart = start;
+            if (elapsed < RAGE_TRIGGER_TIME) {
+                co_await behaviour.until(start + RAGE_TRIGGER_TIME);
+                setSpeedUnits(getSpeedUnits() * 3);
+                setColor(sf::Color(255, 60, 60)); // Rage tint
+            }
+
+            co_await behaviour.until(start + RAGE_TRIGGER_TIME + RAGE_DURATION);
+            setSpeedUnits(getSpeedUnits() / 3); // Reset speed
+            setColor(getOriginalColor());       // Reset color
+        }
+    }
+
+    float getRageTriggerTimer() const { return static_cast<float>(behaviour.now() - cycleStart); }
+
+public:
+    ChaserGhost(const std::string& spriteSheetPath,
+        int frameCount, int frameWidth, int frameHeight,
+        float x, float y, float speed, float scale,
+        const std::map<Direction, int>& frameIndexes)
+        : Ghost(spriteSheetPath, frameCount, frameWidth, frameHeight, x, y, speed, scale, frameIndexes),
+        cycleStart(0.0)
+    {
+        behaviour.start(script(0.0f));
+    }
+
+    void Reset() override {
+        bool wasRaging = getIsRaging();
+        Ghost::Reset();
+        if (wasRaging) setSpeedUnits(getSpeedUnits() / 3);
+        setColor(getOriginalColor());
+        behaviour.start(script(0.0f));
+    }
+
+    bool getIsRaging() const { return getRageTriggerTimer() >= RAGE_TRIGGER_TIME; }
+
+    GhostKind kind() const override { return GHOST_CHASER; }
+
+    void saveState(GhostState& state) const override {
+        Ghost::saveState(state);
+        float rageTriggerTimer = getRageTriggerTimer();
+        state.timers[0] = rageTriggerTimer;
+        state.timers[1] = std::max(0.0f, rageTriggerTimer - RAGE_TRIGGER_TIME);
+        if (getIsRaging()) state.flags |= GF_RAGING;
+    }
+
+    // The rage timer follows from the trigger timer, the script picks up from there
+    void loadState(const GhostState& state) override {
+        Ghost::loadState(state);
+        behaviour.start(script(state.timers[0]));
+    }
 };
\ No newline at end of file
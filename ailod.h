@@ -0,0 +1,121 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Level-of-detail scheduling for ghost AI.
+//
+// Every tick GameWorld asks the scheduler how much of each ghost to simulate,
+// from the ghost's tile distance to Pacman:
+//
+//   FULL     near Pacman: updateAutonomous, collision and Update every tick,
+//            exactly as without the scheduler.
+//   REDUCED  further out: a full update every REDUCED_INTERVAL ticks. In
+//            between the ghost only keeps going along its corridor
+//            (Ghost::extrapolate). Where that needs a decision it gets a
+//            full update on the spot. The time skipped is handed to Update
+//            with the next full update, so its timers keep up.
+//   ASLEEP   beyond SLEEP_DISTANCE: not touched at all, its time piles up
+//            for when it wakes.
+//
+// The camera always contains Pacman, so a ghost the window can show is never
+// further than the window's size in tiles from him. NEAR_COLS/NEAR_ROWS are
+// that size plus the cull margin: every ghost on screen runs at full rate.
+// Collisions can only happen within that distance, too.
+//
+// Waking: when Pacman comes close, or on an event that concerns every ghost
+// (super mode, a life lost, a ghost eaten), wakeAll() keeps everything at
+// least REDUCED for WAKE_TICKS.
+//
+// Each ghost rolls its numbers from its own per-tick seed (Ghost::reseed).
+// A far ghost skipping a tick therefore doesn't shift the numbers the near
+// ones get, so everything near the player comes out the same as without the
+// scheduler. The decision only looks at simulation state, so replays stay
+// deterministic.
+
+class AiLodScheduler {
+public:
+    enum Level : uint8_t { FULL, REDUCED, ASLEEP };
+
+    static const int NEAR_COLS = 26;           // 960 px window in 40 px tiles, plus two
+    static const int NEAR_ROWS = 29;           // 1050 px
+    static const int SLEEP_DISTANCE = 64;      // tiles along either axis
+    static const int REDUCED_INTERVAL = 4;     // ticks between full updates of a REDUCED ghost
+    static const int WAKE_TICKS = 120;
+
+    struct Stats {
+        uint64_t full = 0;                     // ghost updates run in full
+        uint64_t extrapolated = 0;             // ghost moved along its corridor only
+        uint64_t asleep = 0;                   // ghost not touched
+        uint64_t wakes = 0;                    // ghosts that left ASLEEP
+
+        uint64_t saved() const { return extrapolated + asleep; }
+    };
+
+private:
+    struct Entry {
+        Level level = FULL;
+        float pendingDt = 0.f;                 // time not yet given to Update
+    };
+
+    std::vector<Entry> entries;
+    int awakeTicks = 0;
+    Stats stats;
+
+public:
+    // Back to everything FULL with no pending time: new round, life lost, a
+    // snapshot loaded (the pending time isn't part of GameState)
+    void reset(size_t ghostCount) {
+        entries.assign(ghostCount, Entry());
+        awakeTicks = 0;
+    }
+
+    void resetStats() { stats = Stats(); }
+    const Stats& getStats() const { return stats; }
+
+    // Nobody sleeps for the next WAKE_TICKS ticks
+    void wakeAll() {
+        awakeTicks = WAKE_TICKS;
+    }
+
+    // Once per tick before the ghost loop
+    void beginTick(size_t ghostCount) {
+        if (entries.size() != ghostCount) entries.resize(ghostCount);
+        if (awakeTicks > 0) awakeTicks--;
+    }
+
+    // How much of ghost i to simulate this tick
+    Level classify(size_t i, sf::Vector2i ghostTile, sf::Vector2i pacmanTile) {
+        int dx = std::abs(ghostTile.x - pacmanTile.x);
+        int dy = std::abs(ghostTile.y - pacmanTile.y);
+        Level level = FULL;
+        if (dx > SLEEP_DISTANCE || dy > SLEEP_DISTANCE) level = awakeTicks > 0 ? REDUCED : ASLEEP;
+        else if (dx > NEAR_COLS || dy > NEAR_ROWS) level = REDUCED;
+
+        if (entries[i].level == ASLEEP && level != ASLEEP) stats.wakes++;
+        entries[i].level = level;
+        return level;
+    }
+
+    // A REDUCED ghost's turn for a full update
+    static bool isFullTick(size_t i, uint32_t tick) {
+        return (tick + static_cast<uint32_t>(i)) % REDUCED_INTERVAL == 0;
+    }
+
+    // The ghost was only moved along its corridor, or not at all
+    void deferred(size_t i, float dt, bool moved) {
+        entries[i].pendingDt += dt;
+        if (moved) stats.extrapolated++;
+        else stats.asleep++;
+    }
+
+    // Full update: this tick's time plus whatever was skipped
+    float takeFull(size_t i, float dt) {
+        float total = entries[i].pendingDt + dt;
+        entries[i].pendingDt = 0.f;
+        stats.full++;
+        return total;
+    }
+};
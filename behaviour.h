@@ -0,0 +1,251 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Ghost behaviour scripts as C++20 coroutines.
+//
+// A behaviour reads top to bottom, "wander 8 s, flicker 2 s, teleport":
+//
+//     Behaviour TeleporterGhost::script(float elapsed) {
+//         for (double start = behaviour.now() - elapsed;; start += TELEPORT_INTERVAL) {
+//             co_await behaviour.until(start + TELEPORT_INTERVAL - FLICKER_DURATION);
+//             ...
+//         }
+//     }
+//
+// Every ghost owns a BehaviourRunner with a clock of its own, advanced by
+// Ghost::Update. The runner holds the one suspended coroutine and the time it
+// waits for. advance() is an add and a compare until that time comes, and only
+// then resumes the script. A ghost waiting out a 30 second cooldown costs
+// nothing more than that.
+//
+// Each ghost has its own clock because the AI LOD scheduler (ailod.h) hands
+// ghosts different amounts of time, and because ghosts update in parallel
+// jobs (jobs.h). A runner is only ever touched from its own ghost.
+//
+// until() with a time that has already passed doesn't suspend. A script
+// restarted part-way through (Ghost::loadState) therefore runs straight to
+// where it was. When one long Update covers several waits, they all fire in
+// order.
+//
+// Coroutine frames come from BehaviourPool rather than the heap. Frames are
+// only made when a script starts (spawn, Reset, loadState), never while one
+// runs.
+
+// Free lists of fixed-size blocks, one per size class, carved from 16 KiB
+// slabs that are kept for the life of the process. Frames of the same script
+// are all the same size, so a restarted script reuses the block it just
+// freed. Bigger frames than the largest class go to the heap.
+class BehaviourPool {
+public:
+    struct Stats {
+        uint64_t allocations = 0;
+        uint64_t live = 0;
+        uint64_t slabs = 0;
+    };
+
+private:
+    static const size_t CLASS_COUNT = 4;            // 128, 256, 512, 1024 bytes
+    static const size_t SMALLEST = 128;
+    static const size_t SLAB_SIZE = 16 * 1024;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::mutex mutex;                               // scripts start on the sim thread, but also in tools
+    FreeBlock* freeLists[CLASS_COUNT] = {};
+    Stats stats;
+
+    static size_t classSize(size_t sizeClass) { return SMALLEST << sizeClass; }
+
+    // CLASS_COUNT for frames that go to the heap
+    static size_t classOf(size_t size) {
+        size_t sizeClass = 0;
+        while (sizeClass < CLASS_COUNT && classSize(sizeClass) < size) sizeClass++;
+        return sizeClass;
+    }
+
+    void refill(size_t sizeClass) {
+        size_t size = classSize(sizeClass);
+        char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+        stats.slabs++;
+        for (size_t offset = 0; offset + size <= SLAB_SIZE; offset += size) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset);
+            block->next = freeLists[sizeClass];
+            freeLists[sizeClass] = block;
+        }
+    }
+
+public:
+    // Never destroyed: ghosts in static objects may free their frames after
+    // any pool with static storage would be gone
+    static BehaviourPool& instance() {
+        static BehaviourPool* pool = new BehaviourPool();
+        return *pool;
+    }
+
+    BehaviourPool() = default;
+    BehaviourPool(const BehaviourPool&) = delete;
+    BehaviourPool& operator=(const BehaviourPool&) = delete;
+
+    void* allocate(size_t size) {
+        size_t sizeClass = classOf(size);
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.allocations++;
+        stats.live++;
+        if (sizeClass == CLASS_COUNT) return ::operator new(size);
+        if (!freeLists[sizeClass]) refill(sizeClass);
+        FreeBlock* block = freeLists[sizeClass];
+        freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    // size must be the one the block was allocated with
+    void deallocate(void* p, size_t size) {
+        size_t sizeClass = classOf(size);
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.live--;
+        if (sizeClass == CLASS_COUNT) {
+            ::operator delete(p);
+            return;
+        }
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = freeLists[sizeClass];
+        freeLists[sizeClass] = block;
+    }
+
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+};
+
+// The coroutine type of a behaviour script. Starts suspended; the runner
+// owning it resumes it and destroys it.
+class Behaviour {
+public:
+    struct promise_type {
+        Behaviour get_return_object() {
+            return Behaviour(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return BehaviourPool::instance().allocate(size); }
+        static void operator delete(void* p, size_t size) { BehaviourPool::instance().deallocate(p, size); }
+    };
+
+    Behaviour() = default;
+    Behaviour(Behaviour&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Behaviour& operator=(Behaviour&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Behaviour() { reset(); }
+
+    Behaviour(const Behaviour&) = delete;
+    Behaviour& operator=(const Behaviour&) = delete;
+
+    bool running() const { return handle && !handle.done(); }
+    void resume() { handle.resume(); }
+
+    void reset() {
+        if (handle) handle.destroy();
+        handle = nullptr;
+    }
+
+private:
+    explicit Behaviour(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Runs one ghost's behaviour script on the ghost's own clock (see above)
+class BehaviourRunner {
+private:
+    static constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+    Behaviour script;
+    double clock = 0.0;
+    double wakeAt = NEVER;
+    bool waitingForSignal = false;
+
+    // Resume the script for as long as its wait has run out
+    void run() {
+        while (script.running() && clock >= wakeAt) {
+            script.resume();
+        }
+    }
+
+public:
+    struct Until {
+        BehaviourRunner& runner;
+        double time;
+
+        bool await_ready() const noexcept { return time <= runner.clock; }
+        void await_suspend(std::coroutine_handle<>) noexcept { runner.wakeAt = time; }
+        void await_resume() const noexcept {}
+    };
+
+    struct Signalled {
+        BehaviourRunner& runner;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) noexcept {
+            runner.wakeAt = NEVER;
+            runner.waitingForSignal = true;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    BehaviourRunner() = default;
+    BehaviourRunner(const BehaviourRunner&) = delete;
+    BehaviourRunner& operator=(const BehaviourRunner&) = delete;
+
+    // Replace the script and run it up to its first wait. The clock carries on.
+    void start(Behaviour behaviour) {
+        script = std::move(behaviour);
+        waitingForSignal = false;
+        wakeAt = clock;
+        run();
+    }
+
+    void stop() {
+        script.reset();
+        wakeAt = NEVER;
+        waitingForSignal = false;
+    }
+
+    void advance(float dt) {
+        clock += dt;
+        if (clock >= wakeAt) run();
+    }
+
+    // Wake a script waiting in signalled() right now, without advancing the clock
+    void signal() {
+        if (!waitingForSignal) return;
+        waitingForSignal = false;
+        wakeAt = clock;
+        run();
+    }
+
+    double now() const { return clock; }
+
+    // co_await runner.until(t): carry on once the clock reaches t
+    Until until(double time) { return Until{ *this, time }; }
+
+    // co_await runner.signalled(): carry on once signal() is called
+    Signalled signalled() { return Signalled{ *this }; }
+};
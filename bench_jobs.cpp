@@ -0,0 +1,141 @@
+// Scaling benchmark for the ghost AI job system (jobs.h).
+//
+//     g++ -O2 -std=c++20 bench_jobs.cpp -o bench_jobs -lsfml-graphics -lsfml-window -lsfml-system -pthread
+//     ./bench_jobs [--ghosts N] [--ticks N] [--size N] [--seed N] [--max-threads N]
+//
+// Plays the same round several times: a generated SIZE x SIZE maze, N ghosts
+// cycling through every ghost type, Pacman standing still in the top left
+// corner. First without a job system, then with 1, 2, 4, ... threads up to
+// --max-threads (default: every core). The calling thread counts as one.
+// Reports milliseconds per tick, the speedup over one thread and how many
+// pieces were stolen. Every ghost's position, direction and colour, plus score
+// and lives, are hashed after every tick. It exits 1 if any run ends on a
+// different hash than the serial one.
+#include "gameworld.h"
+#include "jobs.h"
+#include "mazegen.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* const GHOST_TYPES[] = {
+    "TELEPORTER", "RANDOMGHOST", "CHASER", "AMBUSHER", "HERMES", "PHANTOM", "TIMESTOP", "RINGGHOST"
+};
+
+struct RunResult {
+    double millisPerTick = 0;
+    uint64_t hash = 0;
+    uint64_t steals = 0;
+};
+
+// FNV-1a
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+static void hashWorld(uint64_t& hash, const GameWorld& world) {
+    for (const Ghost* ghost : world.ghosts) {
+        sf::Vector2f position = ghost->GetPosition();
+        uint8_t direction = static_cast<uint8_t>(ghost->GetCurrentDirection());
+        sf::Color color = ghost->getSprite().getColor();
+        hashBytes(hash, &position.x, sizeof(position.x));
+        hashBytes(hash, &position.y, sizeof(position.y));
+        hashBytes(hash, &direction, sizeof(direction));
+        hashBytes(hash, &color, sizeof(color));
+    }
+    hashBytes(hash, &world.score, sizeof(world.score));
+    hashBytes(hash, &world.lives, sizeof(world.lives));
+}
+
+// threads 0 runs without a job system
+static RunResult run(const std::vector<std::string>& rows, const std::vector<std::string>& lineup,
+    uint32_t seed, int ticks, int threads) {
+    GameWorld world{ map<Direction, string>() };
+    Maze maze(rows);
+    world.startNextLevel(maze);
+    world.startRound(lineup, seed);
+    float cell = static_cast<float>(Maze::getCellSize());
+    world.pacman.SetPosition(world.maze.getOffset().x + cell, world.maze.getOffset().y + cell);
+
+    std::unique_ptr<JobSystem> jobs;
+    if (threads > 0) {
+        jobs.reset(new JobSystem(threads - 1));
+        world.jobs = jobs.get();
+    }
+
+    RunResult result;
+    result.hash = 1469598103934665603ull;
+    double totalMillis = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        auto start = std::chrono::steady_clock::now();
+        world.update(1.f / 60.f);
+        totalMillis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        hashWorld(result.hash, world);
+    }
+    result.millisPerTick = totalMillis / ticks;
+    if (jobs) result.steals = jobs->getStats().steals;
+    world.jobs = nullptr;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int ghostCount = 512, ticks = 600, size = 101;
+    int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ghosts" && hasValue) ghostCount = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--ticks" && hasValue) ticks = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--size" && hasValue) size = std::max(21, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--max-threads" && hasValue) maxThreads = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr, "usage: bench_jobs [--ghosts N] [--ticks N] [--size N] [--seed N] [--max-threads N]\n");
+            return 2;
+        }
+    }
+
+    Ghost::headless() = true;
+    std::vector<std::string> rows = MazeGenerator::generate(size, size, seed);
+    std::vector<std::string> lineup;
+    for (int i = 0; i < ghostCount; ++i) {
+        lineup.push_back(GHOST_TYPES[i % (sizeof(GHOST_TYPES) / sizeof(GHOST_TYPES[0]))]);
+    }
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::printf("%d ghosts, %dx%d maze, %d ticks\n", ghostCount, size, size, ticks);
+    std::printf("%-8s %10s %8s %8s  %s\n", "threads", "ms/tick", "speedup", "steals", "hash");
+
+    RunResult serial = run(rows, lineup, seed, ticks, 0);
+    std::printf("%-8s %10.3f %8s %8s  %016llx\n", "serial", serial.millisPerTick, "", "",
+        static_cast<unsigned long long>(serial.hash));
+
+    bool identical = true;
+    double single = 0;
+    for (int threads : threadCounts) {
+        RunResult result = run(rows, lineup, seed, ticks, threads);
+        if (threads == 1) single = result.millisPerTick;
+        bool same = result.hash == serial.hash;
+        identical = identical && same;
+        std::printf("%-8d %10.3f %7.2fx %8llu  %016llx%s\n", threads, result.millisPerTick,
+            result.millisPerTick > 0 ? single / result.millisPerTick : 0.0,
+            static_cast<unsigned long long>(result.steals), static_cast<unsigned long long>(result.hash),
+            same ? "" : "  DIFFERS FROM SERIAL");
+    }
+    return identical ? 0 : 1;
+}
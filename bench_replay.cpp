@@ -0,0 +1,256 @@
+// Replays recorded sessions through GameWorld and reports simulation performance.
+// The game writes the last round it played to last_session.pmr (see session.h).
+//
+//     g++ -O2 -std=c++20 bench_replay.cpp -o bench_replay -lsfml-graphics -lsfml-window -lsfml-system
+//     ./bench_replay [options] session.pmr...
+//
+//     --render              also draw every tick into an offscreen RenderTexture (needs a display)
+//     --repeat N            replay each session N times, default 5
+//     --baseline FILE       compare against a baseline, exit 1 on regression
+//     --tolerance T         allowed relative regression, default 0.10
+//     --write-baseline FILE store this run as the new baseline
+//     --json FILE           write the results as JSON (stdout otherwise)
+//
+// Per session it reports ticks per second, per-tick p50/p99/max in microseconds
+// and heap allocations per tick, so a change that makes the update loop slower or
+// starts allocating in it fails the run.
+#include "gameworld.h"
+#include "session.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Counts every heap allocation the process makes
+static std::atomic<uint64_t> allocationCount(0);
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t ticks = 0;
+    double ticksPerSecond = 0;
+    double p50Micros = 0;
+    double p99Micros = 0;
+    double maxMicros = 0;
+    double allocsPerTick = 0;
+};
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+static double percentile(std::vector<float>& samples, double p) {
+    if (samples.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static BenchResult runSession(const Session& session, const std::string& name, int repeat, bool render) {
+    map<Direction, string> pacPaths;
+    if (render) {
+        pacPaths = { { UP, "PACMANUP.png" }, { DOWN, "PACMANDOWN.png" },
+            { LEFT, "PACMANLEFT.png" }, { RIGHT, "PACMANRIGHT.png" } };
+    }
+    GameWorld world(pacPaths);
+
+    RenderTexture target;
+    RenderQueue queue;
+    if (render && !target.create(960, 1050)) {
+        std::fprintf(stderr, "could not create render target, running without --render\n");
+        render = false;
+    }
+
+    std::vector<float> tickMicros;
+    tickMicros.reserve(session.ticks.size() * repeat);
+    double totalSeconds = 0;
+    uint64_t allocations = 0;
+
+    for (int run = 0; run < repeat; ++run) {
+        world.startRound(session.lineup, session.seed);
+
+        for (const SessionTick& t : session.ticks) {
+            uint64_t allocsBefore = allocationCount.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+
+            world.applyInput(t.input);
+            TickEvents events = world.update(t.dt);
+            if (render) {
+                target.clear();
+                world.draw(queue);
+                queue.flush(target);
+                target.display();
+            }
+
+            auto end = std::chrono::steady_clock::now();
+            allocations += allocationCount.load(std::memory_order_relaxed) - allocsBefore;
+            float micros = std::chrono::duration<float, std::micro>(end - start).count();
+            tickMicros.push_back(micros);
+            totalSeconds += micros * 1e-6;
+
+            if (events.won || world.lives <= 0) break;
+        }
+        world.endRound();
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.ticks = tickMicros.size();
+    if (result.ticks == 0) return result;
+    result.ticksPerSecond = totalSeconds > 0 ? result.ticks / totalSeconds : 0;
+    result.maxMicros = *std::max_element(tickMicros.begin(), tickMicros.end());
+    result.p50Micros = percentile(tickMicros, 0.50);
+    result.p99Micros = percentile(tickMicros, 0.99);
+    result.allocsPerTick = static_cast<double>(allocations) / result.ticks;
+    return result;
+}
+
+static std::string toJson(const std::vector<BenchResult>& results, bool render) {
+    std::ostringstream out;
+    out << "{\n  \"render\": " << (render ? "true" : "false") << ",\n  \"sessions\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"ticks\": %llu, \"ticks_per_sec\": %.1f, \"p50_us\": %.2f, "
+            "\"p99_us\": %.2f, \"max_us\": %.2f, \"allocs_per_tick\": %.3f}%s\n",
+            r.name.c_str(), static_cast<unsigned long long>(r.ticks), r.ticksPerSecond,
+            r.p50Micros, r.p99Micros, r.maxMicros, r.allocsPerTick, i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+// Baseline files hold one line per session:
+//     name ticks_per_sec p50_us p99_us max_us allocs_per_tick
+static bool writeBaseline(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+    for (const BenchResult& r : results) {
+        out << r.name << ' ' << r.ticksPerSecond << ' ' << r.p50Micros << ' ' << r.p99Micros << ' '
+            << r.maxMicros << ' ' << r.allocsPerTick << '\n';
+    }
+    return out.good();
+}
+
+static bool readBaseline(const std::string& path, std::vector<BenchResult>& baseline) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    BenchResult r;
+    while (in >> r.name >> r.ticksPerSecond >> r.p50Micros >> r.p99Micros >> r.maxMicros >> r.allocsPerTick) {
+        baseline.push_back(r);
+    }
+    return true;
+}
+
+// Throughput, tail latency and allocation rate may each get worse by tolerance.
+// The max is too noisy to gate on and is only reported.
+static int compare(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline, double tolerance) {
+    int regressions = 0;
+    for (const BenchResult& r : results) {
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+            [&](const BenchResult& b) { return b.name == r.name; });
+        if (base == baseline.end()) {
+            std::fprintf(stderr, "%s: no baseline, skipped\n", r.name.c_str());
+            continue;
+        }
+
+        auto check = [&](const char* what, double now, double before, bool higherIsBetter, double slack) {
+            bool worse = higherIsBetter ? now < before * (1.0 - tolerance)
+                                        : now > before * (1.0 + tolerance) + slack;
+            std::fprintf(stderr, "%s %-16s %-15s %10.2f -> %10.2f\n",
+                worse ? "REGRESSION" : "ok        ", r.name.c_str(), what, before, now);
+            if (worse) regressions++;
+        };
+        check("ticks_per_sec", r.ticksPerSecond, base->ticksPerSecond, true, 0);
+        check("p99_us", r.p99Micros, base->p99Micros, false, 0);
+        check("allocs_per_tick", r.allocsPerTick, base->allocsPerTick, false, 0.01);
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    bool render = false;
+    int repeat = 5;
+    double tolerance = 0.10;
+    std::string baselinePath, writeBaselinePath, jsonPath;
+    std::vector<std::string> sessionPaths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--render") render = true;
+        else if (arg == "--repeat" && hasValue) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--tolerance" && hasValue) tolerance = std::atof(argv[++i]);
+        else if (arg == "--write-baseline" && hasValue) writeBaselinePath = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return 2;
+        }
+        else sessionPaths.push_back(arg);
+    }
+    if (sessionPaths.empty()) {
+        std::fprintf(stderr, "usage: bench_replay [--render] [--repeat N] [--baseline FILE] "
+            "[--tolerance T] [--write-baseline FILE] [--json FILE] session.pmr...\n");
+        return 2;
+    }
+
+    Ghost::headless() = !render;
+
+    std::vector<BenchResult> results;
+    for (const std::string& path : sessionPaths) {
+        Session session;
+        if (!session.load(path)) {
+            std::fprintf(stderr, "could not read session %s\n", path.c_str());
+            return 2;
+        }
+        results.push_back(runSession(session, baseName(path), repeat, render));
+    }
+
+    std::string json = toJson(results, render);
+    if (jsonPath.empty()) {
+        std::fputs(json.c_str(), stdout);
+    }
+    else {
+        std::ofstream out(jsonPath);
+        out << json;
+    }
+
+    if (!writeBaselinePath.empty() && !writeBaseline(writeBaselinePath, results)) {
+        std::fprintf(stderr, "could not write baseline %s\n", writeBaselinePath.c_str());
+        return 2;
+    }
+
+    if (!baselinePath.empty()) {
+        std::vector<BenchResult> baseline;
+        if (!readBaseline(baselinePath, baseline)) {
+            std::fprintf(stderr, "could not read baseline %s\n", baselinePath.c_str());
+            return 2;
+        }
+        if (compare(results, baseline, tolerance) > 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+
+// Scrolling camera for mazes larger than the window.
+//
+// The camera is a window-sized sf::View centred on Pacman and clamped to the
+// maze, so the board only scrolls once Pacman heads for a part the window can't
+// show. Along an axis where the whole maze fits, the view stays where the
+// window's default view is, which leaves the stock maze looking as it always did.
+//
+// cullRect() is the view grown by MARGIN on every side. Maze::draw and the
+// sprite submission skip whatever lies outside it, so the cost of a frame
+// follows the window size instead of the maze size. The margin also covers the
+// difference between the tick a snapshot was culled at and the blended Pacman
+// position the window thread centres the view on.
+
+// What a frame's culling kept and skipped, shown by the F3 overlay
+struct CullStats {
+    uint32_t tilesDrawn = 0;      // tiles inside the cull rect, walls and pellets among them
+    uint32_t tilesCulled = 0;
+    uint32_t spritesDrawn = 0;    // ghosts and Pacman
+    uint32_t spritesCulled = 0;
+};
+
+class Camera {
+public:
+    static constexpr float MARGIN = 80.f;   // two tiles
+
+private:
+    sf::Vector2f viewSize;
+    sf::Vector2f center;
+
+    // Centre along one axis: on the focus, but never showing past the maze
+    static float clampAxis(float focus, float start, float length, float view) {
+        if (length <= view) return view / 2.f;
+        return std::min(std::max(focus, start + view / 2.f), start + length - view / 2.f);
+    }
+
+public:
+    Camera() {}
+    explicit Camera(sf::Vector2f viewSize) : viewSize(viewSize), center(viewSize / 2.f) {}
+
+    void setViewSize(sf::Vector2f size) {
+        viewSize = size;
+        center = size / 2.f;
+    }
+
+    // Centre on focus, kept inside the maze's bounds
+    void follow(sf::Vector2f focus, const sf::FloatRect& bounds) {
+        center.x = clampAxis(focus.x, bounds.left, bounds.width, viewSize.x);
+        center.y = clampAxis(focus.y, bounds.top, bounds.height, viewSize.y);
+    }
+
+    sf::View view() const { return sf::View(center, viewSize); }
+
+    // World rectangle the window shows
+    sf::FloatRect visibleRect() const {
+        return sf::FloatRect(center.x - viewSize.x / 2.f, center.y - viewSize.y / 2.f, viewSize.x, viewSize.y);
+    }
+
+    // What gets drawn: the visible rectangle plus MARGIN on every side
+    sf::FloatRect cullRect() const {
+        sf::FloatRect visible = visibleRect();
+        return sf::FloatRect(visible.left - MARGIN, visible.top - MARGIN,
+            visible.width + 2 * MARGIN, visible.height + 2 * MARGIN);
+    }
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+using namespace sf;
+
+// Animated background dots of the menu screens
+
+struct Dot {
+    CircleShape shape;
+    float speed;
+    float angle;  // For circular motion
+    float radius; // For circular motion
+    Vector2f center; // Center point for circular motion
+    float oscillation; // For pulsing
+    bool isPulsing; // Whether this dot pulses
+};
+
+void generateBackgroundDots(vector<Dot>& dots, int windowWidth, int windowHeight) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * 3.14159f);
+    std::uniform_real_distribution<float> radiusDist(100.0f, 350.0f);
+    std::uniform_real_distribution<float> speedDist(0.5f, 2.5f);
+    std::uniform_real_distribution<float> oscDist(0.0f, 2.0f * 3.14159f);
+    std::bernoulli_distribution isPulsingDist(0.3f); // 30% chance for pulsing dots
+
+    // Create standard moving dots
+    for (int i = 0; i < 50; ++i) {
+        CircleShape dot(2 + static_cast<float>(rand() % 3)); // Varied sizes
+
+        // Random vibrant colors for some dots
+        if (rand() % 5 == 0) { // 20% chance for colored dots
+            dot.setFillColor(Color(rand() % 255, rand() % 255, rand() % 255, 150 + rand() % 100));
+        }
+        else {
+            dot.setFillColor(Color(200, 200, 200, 150 + rand() % 100)); // White/gray with alpha
+        }
+
+        dot.setPosition(rand() % windowWidth, rand() % windowHeight);
+        float speed = speedDist(gen);
+        dots.push_back({ dot, speed, 0, 0, {0, 0}, 0, false });
+    }
+
+    // Create orbital dots
+    for (int i = 0; i < 30; ++i) {
+        CircleShape dot(1 + static_cast<float>(rand() % 2));
+        dot.setFillColor(Color::Yellow);
+
+        Vector2f center(windowWidth / 2.0f, 300.0f);
+        float radius = radiusDist(gen);
+        float angle = angleDist(gen);
+        float speed = speedDist(gen) * 0.5f;
+
+        // Calculate position based on center, radius and angle
+        float x = center.x + radius * cos(angle);
+        float y = center.y + radius * sin(angle);
+        dot.setPosition(x, y);
+
+        bool isPulsing = isPulsingDist(gen);
+        float oscillation = oscDist(gen);
+
+        dots.push_back({ dot, speed, angle, radius, center, oscillation, isPulsing });
+    }
+}
+
+void updateDots(vector<Dot>& dots, float dt, int windowHeight) {
+    for (auto& d : dots) {
+        if (d.radius > 0) {
+            // This is an orbital dot
+            d.angle += d.speed * dt;
+
+            // Calculate new position based on center, radius and updated angle
+            float x = d.center.x + d.radius * cos(d.angle);
+            float y = d.center.y + d.radius * sin(d.angle);
+
+            d.shape.setPosition(x, y);
+
+            // Handle pulsing effect
+            if (d.isPulsing) {
+                d.oscillation += dt * 3.0f;
+                float scale = 0.7f + 0.3f * sin(d.oscillation);
+                float currentRadius = d.shape.getRadius();
+                d.shape.setRadius(currentRadius * scale);
+
+                // Adjust color based on oscillation
+                float brightness = 150 + 105 * sin(d.oscillation);
+                d.shape.setFillColor(Color(255, 255, brightness, 200));
+            }
+        }
+        else {
+            // This is a standard moving dot
+            Vector2f pos = d.shape.getPosition();
+            pos.y += d.speed;
+            if (pos.y > windowHeight) pos.y = 0;
+            d.shape.setPosition(pos);
+        }
+    }
+}
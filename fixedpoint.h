@@ -0,0 +1,58 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cmath>
+#include <cstdint>
+
+// Fixed-point positions for the simulation.
+//
+// A coordinate is an int32_t counting 1/256 of a pixel (24.8). A 40 px tile is
+// exactly 40 * ONE units, so the tile a point is in and its distance from the
+// tile's centre are integer divisions and compares. The result is the same on
+// every compiler and at every frame rate. Every speed the game uses (2.5, 3.5,
+// 7.5 px per tick, ...) is a whole number of units per tick.
+//
+// Floats only come in at the edges. fromPixels rounds positions and speeds
+// given in pixels to the nearest unit. toPixels is exact for any maze under
+// 32768 px, so a sprite placed from a FixedPos sits exactly on the
+// simulation's position.
+struct FixedPos {
+    static const int FRACTION_BITS = 8;
+    static const int32_t ONE = 1 << FRACTION_BITS;    // one pixel
+
+    int32_t x = 0;
+    int32_t y = 0;
+
+    FixedPos() = default;
+    FixedPos(int32_t x, int32_t y) : x(x), y(y) {}
+
+    static int32_t fromPixels(float pixels) {
+        return static_cast<int32_t>(std::lround(pixels * ONE));
+    }
+
+    static FixedPos fromPixels(sf::Vector2f pixels) {
+        return FixedPos(fromPixels(pixels.x), fromPixels(pixels.y));
+    }
+
+    static float toPixels(int32_t units) {
+        return static_cast<float>(units) / ONE;
+    }
+
+    sf::Vector2f toPixels() const {
+        return sf::Vector2f(toPixels(x), toPixels(y));
+    }
+
+    bool operator==(const FixedPos& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const FixedPos& other) const { return !(*this == other); }
+};
+
+// Integer division rounding down, so points left of or above the maze's
+// origin land in tile -1 rather than 0
+inline int32_t floorDiv(int32_t a, int32_t b) {
+    int32_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// What floorDiv leaves over, always in [0, b) for positive b
+inline int32_t floorMod(int32_t a, int32_t b) {
+    return a - floorDiv(a, b) * b;
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+// Frame pacing.
+//
+// sf::Window::setFramerateLimit sleeps with sf::sleep, which is only as precise as
+// the OS scheduler (1-16 ms on Windows), so frame intervals wander and everything
+// timed off them jitters. PreciseSleeper sleeps coarsely until shortly before
+// the deadline and spins (yielding) for the rest. The spin margin is calibrated
+// from how far the OS has been oversleeping, so the spin stays short.
+//
+// FramePacer uses it to hold any target rate (60/120/144/240) and keeps interval
+// jitter and per-frame miss statistics for the debug overlay.
+
+class PreciseSleeper {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+private:
+    double oversleepMean = 1000.0;     // moving mean and variance of the observed oversleep
+    double oversleepVariance = 0.0;
+    double marginMicros = 1000.0;
+
+public:
+    PreciseSleeper() {
+#ifdef _WIN32
+        timeBeginPeriod(1);   // 1 ms scheduler granularity while we exist
+#endif
+    }
+
+    ~PreciseSleeper() {
+#ifdef _WIN32
+        timeEndPeriod(1);
+#endif
+    }
+
+    PreciseSleeper(const PreciseSleeper&) = delete;
+    PreciseSleeper& operator=(const PreciseSleeper&) = delete;
+
+    void sleepUntil(Clock::time_point deadline) {
+        const double minMargin = 200.0, maxMargin = 4000.0;
+        for (;;) {
+            Clock::time_point now = Clock::now();
+            double remaining = std::chrono::duration<double, std::micro>(deadline - now).count();
+            if (remaining <= marginMicros) break;
+
+            double request = remaining - marginMicros;
+            std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(request));
+            double slept = std::chrono::duration<double, std::micro>(Clock::now() - now).count();
+
+            // Spin for the usual oversleep plus two deviations; the rare scheduler
+            // hiccup beyond that costs one late frame rather than a long spin every frame
+            double delta = (slept - request) - oversleepMean;
+            oversleepMean += 0.05 * delta;
+            oversleepVariance = 0.95 * (oversleepVariance + 0.05 * delta * delta);
+            double margin = oversleepMean + 2.0 * std::sqrt(oversleepVariance);
+            marginMicros = std::min(maxMargin, std::max(minMargin, margin));
+        }
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    double getMarginMicros() const { return marginMicros; }
+};
+
+class FramePacer {
+public:
+    typedef PreciseSleeper::Clock Clock;
+
+    struct Stats {
+        uint64_t frames = 0;
+        double meanIntervalMicros = 0;
+        double jitterMicros = 0;        // standard deviation of the frame interval
+        double lastMissMicros = 0;      // how late the last frame woke up
+        double maxMissMicros = 0;
+        uint64_t lateFrames = 0;        // woke up more than a tenth of a frame late
+    };
+
+private:
+    PreciseSleeper sleeper;
+    bool enabled = true;
+    int targetRate;
+    Clock::duration period;
+    Clock::time_point deadline;
+    Clock::time_point lastWake;
+    bool started = false;
+
+    Stats stats;
+    double intervalSquares = 0;         // Welford running sum for the jitter
+
+public:
+    explicit FramePacer(int targetRate = 60) {
+        setTargetRate(targetRate);
+    }
+
+    void setTargetRate(int rate) {
+        targetRate = std::max(1, rate);
+        period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetRate));
+        resetStats();
+    }
+
+    int getTargetRate() const { return targetRate; }
+
+    void setEnabled(bool on) {
+        enabled = on;
+        resetStats();
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    void resetStats() {
+        stats = Stats();
+        intervalSquares = 0;
+        started = false;
+    }
+
+    // Call once per frame right after display(). Waits for the next frame
+    // deadline; does nothing when disabled.
+    void frameDone() {
+        if (!enabled) return;
+
+        Clock::time_point now = Clock::now();
+        if (!started) {
+            deadline = now;
+            lastWake = now;
+            started = true;
+        }
+        deadline += period;
+        if (now < deadline) {
+            sleeper.sleepUntil(deadline);
+        }
+        Clock::time_point wake = Clock::now();
+
+        double miss = std::chrono::duration<double, std::micro>(wake - deadline).count();
+        double interval = std::chrono::duration<double, std::micro>(wake - lastWake).count();
+        lastWake = wake;
+
+        stats.frames++;
+        double delta = interval - stats.meanIntervalMicros;
+        stats.meanIntervalMicros += delta / stats.frames;
+        intervalSquares += delta * (interval - stats.meanIntervalMicros);
+        stats.jitterMicros = stats.frames > 1 ? std::sqrt(intervalSquares / (stats.frames - 1)) : 0.0;
+        stats.lastMissMicros = miss;
+        stats.maxMissMicros = std::max(stats.maxMissMicros, miss);
+        double periodMicros = std::chrono::duration<double, std::micro>(period).count();
+        if (miss > periodMicros * 0.1) stats.lateFrames++;
+
+        // A frame that overran by more than a whole period starts a new schedule
+        // instead of rushing the following frames to catch up
+        if (miss > periodMicros) deadline = wake;
+    }
+
+    const Stats& getStats() const { return stats; }
+    double getSpinMarginMicros() const { return sleeper.getMarginMicros(); }
+};
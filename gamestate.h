@@ -0,0 +1,184 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Plain-data snapshot of the simulation, kept apart from every render resource
+// (textures, sprites, clocks, strings). A GameState is trivially copyable, so
+// cloning the world for lookahead, rollback or rewind is a single memcpy of
+// well under a kilobyte for the stock maze:
+//
+//     GameState branch = current;   // that's the whole clone
+//
+// Maze, Ghost and MainGame know how to fill one in and how to load one back.
+//
+// The tile planes cover mazes up to MAX_WIDTH x MAX_HEIGHT, which every level
+// of the campaign is (LevelCampaign::validate). A bigger maze, as the tools
+// and the soak runs build, keeps its food in a PelletPlane next to the state
+// (see below); the planes then hold its top left corner.
+
+// Which Ghost subclass a GhostState came from, so it can be restored without RTTI
+enum GhostKind : uint8_t {
+    GHOST_BASIC = 0,
+    GHOST_RING,
+    GHOST_TELEPORTER,
+    GHOST_PHANTOM,
+    GHOST_AMBUSHER,
+    GHOST_TIMESTOP,
+    GHOST_CHASER
+};
+
+// Bits for GhostState::flags (the bool members of the ghost classes)
+enum GhostFlag : uint16_t {
+    GF_SCATTERED = 1 << 0,
+    GF_VISIBLE = 1 << 1,     // RingGhost
+    GF_BLINKING = 1 << 2,    // RingGhost
+    GF_FLICKERING = 1 << 3,  // TeleporterGhost
+    GF_PAUSED = 1 << 4,      // AmbusherGhost
+    GF_PAUSED_TILE = 1 << 5, // AmbusherGhost::hasPausedOnCurrentTile
+    GF_WARNING = 1 << 6,     // TimeStopGhost
+    GF_TIMESTOP = 1 << 7,    // TimeStopGhost
+    GF_RAGING = 1 << 8       // ChaserGhost
+};
+
+struct GhostState {
+    float x, y;
+    float speed;
+    float behaviorTimer;
+    float scatterTimer;
+    float timers[3];         // subclass timers, see each ghost's saveState()
+    int16_t tileX, tileY;    // AmbusherGhost::lastPauseTile
+    uint16_t flags;
+    uint8_t kind;
+    uint8_t direction;
+    uint8_t color[4];        // sprite tint, ghosts turn white in super mode
+};
+
+struct GameState {
+    static const int MAX_WIDTH = 32;   // one uint32_t per row in the tile planes
+    static const int MAX_HEIGHT = 32;
+    static const int MAX_GHOSTS = 8;
+
+    uint32_t tick;
+    uint16_t width, height;            // what the tile planes hold
+    uint16_t mazeWidth, mazeHeight;    // the whole maze, bigger for a PelletPlane's
+
+    // Tile planes, bit (1 << col) of row[row]
+    uint32_t walls[MAX_HEIGHT];
+    uint32_t pellets[MAX_HEIGHT];
+    uint32_t energizers[MAX_HEIGHT];
+    int32_t totalFood;
+    float mazeSuperRemaining;   // Maze's own super mode countdown (seconds)
+
+    // Pacman
+    float pacmanX, pacmanY;
+    uint8_t pacmanDirection;
+    uint8_t pacmanFrozen;
+
+    // Round state owned by MainGame
+    uint8_t superMode;
+    uint8_t ghostCount;
+    int32_t score;
+    int32_t lives;
+    float superModeTimer;
+    float gameTimer;
+    float nextFreezeTime;
+    float freezeStart;
+    uint8_t ghostsBlinking[MAX_GHOSTS];
+    float ghostBlinkTimers[MAX_GHOSTS];
+
+    GhostState ghosts[MAX_GHOSTS];
+
+    void clear() { std::memset(this, 0, sizeof(*this)); }
+
+    bool isWall(int row, int col) const { return testBit(walls, row, col); }
+    bool hasPellet(int row, int col) const { return testBit(pellets, row, col); }
+    bool hasEnergizer(int row, int col) const { return testBit(energizers, row, col); }
+
+    void clearFood(int row, int col) {
+        if (row < 0 || row >= height || col < 0 || col >= width) return;
+        uint32_t mask = 1u << col;
+        if ((pellets[row] | energizers[row]) & mask) totalFood--;
+        pellets[row] &= ~mask;
+        energizers[row] &= ~mask;
+    }
+
+private:
+    bool testBit(const uint32_t* plane, int row, int col) const {
+        if (row < 0 || row >= height || col < 0 || col >= width) return false;
+        return (plane[row] >> col) & 1u;
+    }
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay plain data");
+static_assert(std::is_trivially_copyable<GhostState>::value, "GhostState must stay plain data");
+
+// Food of a maze too big for GameState's inline rows, which a snapshot of it
+// carries alongside the GameState. The plane is cut into 64x64 chunks held by
+// shared_ptr: copying a PelletPlane only copies the chunk pointers, and a
+// write clones just the chunk it touches (copy-on-write). The maze keeps the
+// live plane, so a snapshot costs one pointer per chunk and one chunk per
+// chunk eaten from since.
+// Single-threaded use only, the use_count() check is not a synchronisation point.
+class PelletPlane {
+public:
+    static const int CHUNK = 64;
+
+private:
+    struct Chunk {
+        uint64_t rows[CHUNK];
+    };
+
+    int width = 0;
+    int height = 0;
+    int chunksX = 0;
+    std::vector<std::shared_ptr<Chunk>> chunks;
+
+    std::shared_ptr<Chunk>& chunkAt(int row, int col) {
+        return chunks[(row / CHUNK) * chunksX + col / CHUNK];
+    }
+
+public:
+    PelletPlane() = default;
+
+    PelletPlane(int w, int h) : width(w), height(h) {
+        chunksX = (w + CHUNK - 1) / CHUNK;
+        int chunksY = (h + CHUNK - 1) / CHUNK;
+        // Every chunk starts out sharing one empty block
+        auto empty = std::make_shared<Chunk>();
+        std::memset(empty->rows, 0, sizeof(empty->rows));
+        chunks.assign(static_cast<size_t>(chunksX) * chunksY, empty);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    bool test(int row, int col) const {
+        if (row < 0 || row >= height || col < 0 || col >= width) return false;
+        const Chunk& c = *chunks[(row / CHUNK) * chunksX + col / CHUNK];
+        return (c.rows[row % CHUNK] >> (col % CHUNK)) & 1u;
+    }
+
+    void set(int row, int col, bool value) {
+        if (row < 0 || row >= height || col < 0 || col >= width) return;
+        if (test(row, col) == value) return;   // don't unshare for a no-op
+
+        std::shared_ptr<Chunk>& c = chunkAt(row, col);
+        if (c.use_count() > 1) {
+            c = std::make_shared<Chunk>(*c);
+        }
+        uint64_t mask = uint64_t(1) << (col % CHUNK);
+        if (value) c->rows[row % CHUNK] |= mask;
+        else c->rows[row % CHUNK] &= ~mask;
+    }
+
+    // Whether the chunk holding (row, col) is the same block in both planes,
+    // so nothing in it changed between them
+    bool sharesChunk(const PelletPlane& other, int row, int col) const {
+        size_t index = static_cast<size_t>(row / CHUNK) * chunksX + col / CHUNK;
+        return other.chunksX == chunksX && index < chunks.size() && index < other.chunks.size() &&
+            chunks[index] == other.chunks[index];
+    }
+};
@@ -0,0 +1,679 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "maze.h"
+#include "pacman.h"
+#include "Ghosts.h"
+#include "gamestate.h"
+#include "session.h"
+#include "logger.h"
+#include "renderqueue.h"
+#include "camera.h"
+#include "ailod.h"
+#include "jobs.h"
+#include "timerwheel.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdlib>
+
+using namespace std;
+using namespace sf;
+
+// What happened during one GameWorld::update, so the caller can play sounds
+// and switch screens without the world knowing about either
+struct TickEvents {
+    bool superStarted = false;
+    bool lifeLost = false;
+    bool won = false;
+};
+
+// Pacman touched a ghost this tick, at that point of his step
+struct GhostContact {
+    int32_t at;          // 0 to Maze::SWEEP_END
+    uint32_t ghost;
+};
+
+// Everything that is simulated during a round: the maze, Pacman, the ghosts and
+// the round state that used to live as locals in MainGame. update() runs one
+// tick of gameplay and never touches a window, so the same code path runs in
+// the game, in replays and in the benchmarks.
+struct GameWorld {
+    static constexpr float SUPER_MODE_DURATION = 10.0f; // 10 seconds of super mode
+
+    Maze maze;
+    Vector2f pacmanStartPos;
+    Pacman pacman;
+    vector<Ghost*> ghosts;
+    vector<string> lineup;       // ghost type names, in spawn order
+
+    int score = 0;
+    int lives = 3;
+    bool superMode = false;
+
+    // Ghost states for super mode
+    vector<bool> ghostsBlinking = vector<bool>(4, false);
+    vector<uint32_t> ghostEatenTick = vector<uint32_t>(4, 0);
+    vector<Color> originalGhostColors = vector<Color>(4, Color::White);
+    vector<bool> ghostsReturnToSpawn = vector<bool>(4, false);
+
+    // TimeStop ghost freezes Pacman every now and then
+    bool hasTimeStopGhost = false;
+    bool pacmanFrozen = false;
+    float freezeDuration = 1.5f;
+    float freezeStart = 0.0f;
+    float gameTimer = 0.0f;
+
+    uint32_t tick = 0;
+
+    // Every timer of the round runs on this wheel, in ticks: super mode, the
+    // blinking of eaten ghosts, TimeStop's freezes and the maze's super mode.
+    // update advances it once per tick, so its now() is always tick. A tick
+    // costs only the timers that come due, however many ghosts are blinking.
+    // The ghosts' own behaviour scripts keep their per-ghost clocks
+    // (behaviour.h): LOD hands them time in uneven steps and they run in
+    // parallel jobs.
+    TimerWheel timers;
+    TimerWheel::TimerId superModeEnd = 0;
+    TimerWheel::TimerId nextFreeze = 0;
+    TimerWheel::TimerId freezeEnd = 0;
+    vector<TimerWheel::TimerId> ghostBlinkTimers = vector<TimerWheel::TimerId>(4, 0);
+    static const uint32_t BLINK_TICKS = 12;      // an eaten ghost blinks every 0.2 s
+    static const uint32_t BLINK_STEPS = 10;      // for 2 s, then goes back to the spawn
+    static constexpr float FREEZE_DELAY = 5.0f;  // first TimeStop freeze of a level
+    static constexpr float FREEZE_INTERVAL = 25.0f;
+    unsigned seed = 0;           // ghost decisions are reseeded from this every tick
+    int level = 1;               // campaign level, the stock maze is level 1 (see levels.h)
+
+    // How much of each ghost's AI runs per tick, by distance from Pacman
+    AiLodScheduler aiLod;
+
+    // Runs the ghosts' decisions in parallel when set (see update); null runs
+    // them on the calling thread. Below GHOST_GRAIN ghosts it makes no difference.
+    JobSystem* jobs = nullptr;
+    static const size_t GHOST_GRAIN = 16;
+
+    // What the first phase of update does with each ghost, this tick
+    enum : uint8_t { PLAN_NONE, PLAN_ASLEEP, PLAN_EXTRAPOLATE, PLAN_EXTRAPOLATED, PLAN_FULL };
+    vector<uint8_t> ghostPlans;
+
+    // This tick's moves, swept for food and collisions (see Maze::sweepFood)
+    FixedPos pacmanFrom;
+    FixedPos pacmanTo;
+    bool pacmanJumped = false;         // came out of the side tunnel
+    vector<FixedPos> ghostFrom;
+    vector<FoodHit> foodHits;
+    vector<GhostContact> contacts;
+
+    static Vector2f startPosition(const Maze& maze) {
+        Vector2i cell = maze.getP();
+        Vector2f offset = maze.getOffset();
+        float cellSize = Maze::getCellSize();
+        return Vector2f(cell.x * cellSize + offset.x, cell.y * cellSize + offset.y);
+    }
+
+    GameWorld(const map<Direction, string>& pacPaths)
+        : pacmanStartPos(startPosition(maze)),
+        pacman(pacPaths, 4, 50, 50, pacmanStartPos.x, pacmanStartPos.y, 2.5f)
+    {
+        maze.setTimers(&timers);
+    }
+
+    ~GameWorld() { clearGhosts(); }
+
+    GameWorld(const GameWorld&) = delete;
+    GameWorld& operator=(const GameWorld&) = delete;
+
+    void clearGhosts() {
+        for (TimerWheel::TimerId& id : ghostBlinkTimers) {
+            cancelTimer(id);
+        }
+        for (auto ghost : ghosts) {
+            delete ghost;
+        }
+        ghosts.clear();
+    }
+
+    // Create the ghosts for a line-up of type names (see ghostNames in CODE.cpp)
+    void spawnGhosts(const vector<string>& names) {
+        clearGhosts();
+        lineup = names;
+        hasTimeStopGhost = false;
+
+        map<Direction, int> frameIndexes = {
+            {RIGHT, 0}, {UP, 1}, {DOWN, 2}, {LEFT, 3}
+        };
+
+        // Line-ups longer than the four spawns (bench_jobs) share them in turn
+        for (size_t i = 0; i < names.size(); ++i) {
+            const string& ghostName = names[i];
+            string spriteSheetPath = ghostName + ".png";
+
+            Vector2i ghostPos = maze.getGhost(static_cast<char>('0' + i % 4));
+            if (ghostPos.x == -1 || ghostPos.y == -1) continue;
+
+            static const int TILE_SIZE = 40;
+            float x = ghostPos.x * TILE_SIZE + TILE_SIZE / 2;
+            float y = ghostPos.y * TILE_SIZE + TILE_SIZE / 2;
+
+            Ghost* g;
+            if (ghostName == "HERMES") {
+                g = new Ghost(spriteSheetPath, 4, 50, 50, x, y, 3.5f, 1.3f, frameIndexes);
+            }
+            else if (ghostName == "RINGGHOST") {
+                g = new RingGhost(spriteSheetPath, 4, 50, 50, x, y, 2.5f, 1.3f, frameIndexes);
+            }
+            else if (ghostName == "TELEPORTER") {
+                g = new TeleporterGhost(spriteSheetPath, 4, 50, 50, x, y, 2.5f, 1.3f, frameIndexes);
+            }
+            else if (ghostName == "AMBUSHER") {
+                g = new AmbusherGhost(spriteSheetPath, 4, 50, 50, x, y, 2.5f, 1.3f, frameIndexes);
+            }
+            else if (ghostName == "TIMESTOP") {
+                g = new TimeStopGhost(spriteSheetPath, 4, 50, 50, x, y, 2.5f, 1.3f, frameIndexes);
+                hasTimeStopGhost = true;
+            }
+            else if (ghostName == "CHASER") {
+                g = new ChaserGhost(spriteSheetPath, 4, 50, 50, x, y, 2.5f, 1.3f, frameIndexes);
+            }
+            else {
+                // RANDOMGHOST and PHANTOM move like the base ghost
+                g = new Ghost(spriteSheetPath, 4, 50, 50, x, y, 2.5f, 1.3f, frameIndexes);
+            }
+            ghosts.push_back(g);
+        }
+
+        size_t slots = max<size_t>(4, ghosts.size());
+        ghostsBlinking.assign(slots, false);
+        ghostEatenTick.assign(slots, 0);
+        ghostBlinkTimers.assign(slots, 0);
+        originalGhostColors.assign(slots, Color::White);
+        ghostsReturnToSpawn.assign(slots, false);
+
+        // Store original ghost colors
+        for (size_t i = 0; i < ghosts.size() && i < originalGhostColors.size(); i++) {
+            originalGhostColors[i] = ghosts[i]->getSprite().getColor();
+        }
+    }
+
+    // Set up a fresh round with the given line-up and random seed
+    void startRound(const vector<string>& names, unsigned roundSeed) {
+        seed = roundSeed;
+        tick = 0;
+        score = 0;
+        lives = 3;
+        maze.setSuperMode(false);
+        timers.reset(tick);
+        superMode = false;
+        superModeEnd = 0;
+        pacmanFrozen = false;
+        nextFreeze = freezeEnd = 0;
+        freezeStart = 0.0f;
+        gameTimer = 0.0f;
+        for (size_t i = 0; i < ghostsBlinking.size(); i++) {
+            ghostsBlinking[i] = false;
+            ghostBlinkTimers[i] = 0;
+            ghostsReturnToSpawn[i] = false;
+        }
+        spawnGhosts(names);
+        scheduleFreeze(TimerWheel::ticksFor(FREEZE_DELAY));
+        aiLod.reset(ghosts.size());
+        aiLod.resetStats();
+        pacman.SetPosition(pacmanStartPos.x, pacmanStartPos.y);
+    }
+
+    // Back to the state the menu expects after a round is over
+    void endRound() {
+        lives = 3;
+        superMode = false;
+        clearGhosts();
+        maze.setSuperMode(false);
+        timers.reset(tick);
+        superModeEnd = nextFreeze = freezeEnd = 0;
+        if (level != 1) {
+            // The next round starts the campaign over on the stock maze
+            Maze stock;
+            maze.swap(stock);
+            pacmanStartPos = startPosition(maze);
+            level = 1;
+        }
+        maze.reset();
+        pacman.SetPosition(pacmanStartPos.x, pacmanStartPos.y);
+    }
+
+    // Carry on with the next campaign level. The preloaded maze is swapped in
+    // (the finished one ends up in next); score, lives, the line-up and the
+    // tick count carry over, everyone goes back to the new spawn points.
+    void startNextLevel(Maze& next) {
+        maze.swap(next);
+        level++;
+        pacmanStartPos = startPosition(maze);
+
+        cancelTimer(superModeEnd);
+        superMode = false;
+        cancelTimer(freezeEnd);
+        pacmanFrozen = false;
+        scheduleFreeze(TimerWheel::ticksFor(FREEZE_DELAY));
+        pacman.ResetScale();
+        resetAfterLifeLost();
+    }
+
+    void setPacmanDirection(Direction dir) {
+        pacman.SetDirection(dir);
+    }
+
+    // Apply one tick of recorded or live input (SessionTick::input encoding)
+    void applyInput(uint8_t input) {
+        int dir = input & SESSION_DIRECTION_MASK;
+        if (dir != 0) setPacmanDirection(static_cast<Direction>(dir - 1));
+        if (input & SESSION_SUPER_MODE) forceSuperMode();
+    }
+
+    // Debug key, super mode without eating an energizer
+    void forceSuperMode() {
+        startSuperMode(TimerWheel::ticksFor(SUPER_MODE_DURATION));
+    }
+
+    void eatFood(Vector2i tile, TickEvents& events) {
+        char food = maze.eat(tile);
+        if (food == '.') {
+            score += 10;
+        }
+        else if (food == 'o') {
+            score += 50;
+            startSuperMode(TimerWheel::ticksFor(SUPER_MODE_DURATION));
+            pacman.SuperScale();  // Scale up Pacman for super mode
+            events.superStarted = true;
+            aiLod.wakeAll();
+        }
+    }
+
+    void cancelTimer(TimerWheel::TimerId& id) {
+        timers.cancel(id);
+        id = 0;
+    }
+
+    float superModeRemaining() const {
+        return static_cast<float>(timers.remaining(superModeEnd)) / TimerWheel::TICK_RATE;
+    }
+
+    // Ghosts go white until endSuperMode; eating another energizer starts over
+    void startSuperMode(uint32_t ticks) {
+        superMode = true;
+        timers.cancel(superModeEnd);
+        superModeEnd = timers.schedule(ticks, [this](uint32_t) { endSuperMode(); });
+        for (auto g : ghosts) {
+            g->setColor(Color::White);
+        }
+    }
+
+    void endSuperMode() {
+        superMode = false;
+        superModeEnd = 0;
+
+        // Reset ghost colors when super mode ends
+        for (size_t i = 0; i < ghosts.size() && i < originalGhostColors.size(); i++) {
+            if (!ghostsBlinking[i] && !ghostsReturnToSpawn[i]) {
+                ghosts[i]->setColor(originalGhostColors[i]);
+            }
+        }
+    }
+
+    // Next TimeStop freeze in ticks, if there is a TimeStop ghost
+    void scheduleFreeze(uint32_t ticks) {
+        cancelTimer(nextFreeze);
+        if (hasTimeStopGhost) nextFreeze = timers.schedule(ticks, [this](uint32_t) { freezePacman(); });
+    }
+
+    void freezePacman() {
+        nextFreeze = 0;
+        pacmanFrozen = true;
+        freezeStart = gameTimer;
+        pacman.Stop(pacman.GetDirection());
+        LOG_DEBUG(LOG_GHOST, "[TimeStop] Pac-Man frozen at: %.2f", gameTimer);
+        scheduleUnfreeze(TimerWheel::ticksFor(freezeDuration));
+        scheduleFreeze(TimerWheel::ticksFor(FREEZE_INTERVAL));
+    }
+
+    void scheduleUnfreeze(uint32_t ticks) {
+        cancelTimer(freezeEnd);
+        freezeEnd = timers.schedule(ticks, [this](uint32_t) {
+            freezeEnd = 0;
+            pacmanFrozen = false;
+            LOG_DEBUG(LOG_GHOST, "[TimeStop] Pac-Man unfrozen at: %.2f", gameTimer);
+        });
+    }
+
+    // Pacman ate ghost i: it blinks from the tick it was eaten until
+    // BLINK_STEPS blinks later, then goes back to the spawn
+    void scheduleBlink(size_t i) {
+        uint32_t elapsed = tick - ghostEatenTick[i];
+        uint32_t delay = elapsed < BLINK_TICKS * BLINK_STEPS ? BLINK_TICKS - elapsed % BLINK_TICKS : 0;
+        timers.cancel(ghostBlinkTimers[i]);
+        ghostBlinkTimers[i] = timers.schedule(delay, [this](uint32_t ghost) { blink(ghost); }, static_cast<uint32_t>(i));
+    }
+
+    void blink(size_t i) {
+        Ghost* g = ghosts[i];
+        uint32_t step = (tick - ghostEatenTick[i]) / BLINK_TICKS;
+        ghostBlinkTimers[i] = 0;
+        if (step < BLINK_STEPS) {
+            // Blink effect - toggle visibility every 0.2 seconds
+            if (step % 2 == 0) {
+                g->setColor(Color::White);
+            }
+            else {
+                g->setColor(Color(255, 255, 255, 50));  // Semi-transparent instead of invisible
+            }
+            scheduleBlink(i);
+            return;
+        }
+
+        // After 2 seconds of blinking, return to spawn
+        float cellSize = Maze::getCellSize();
+        ghostsBlinking[i] = false;
+        ghostsReturnToSpawn[i] = true;
+        g->setColor(originalGhostColors[i]);  // Restore original color
+
+        // Set ghost to return to spawn point
+        Vector2i spawnPos = maze.getGhost('0');  // Use ghost 0's spawn position
+        g->SetPosition(
+            spawnPos.x * cellSize + cellSize / 2,
+            spawnPos.y * cellSize + cellSize / 2
+        );
+        ghostsReturnToSpawn[i] = false;
+    }
+
+    TickEvents update(float dt) {
+        TickEvents events;
+
+        // Ghosts roll their own numbers, reseeded from the round seed every tick
+        // below, which keeps rounds replayable
+        tick++;
+
+        gameTimer += dt;
+
+        // Super mode, blinking ghosts, TimeStop and the maze's super mode
+        // change state in timer callbacks, right here
+        timers.advance();
+
+        if (!superMode) {
+            pacman.ResetScale();  // Reset Pacman scale when not in super mode
+        }
+
+        // --- Pac-Man logic ---
+        pacmanFrom = FixedPos::fromPixels(pacman.GetPosition());
+        Direction heading = pacman.GetDirection();
+        foodHits.clear();
+        if (pacmanFrozen == false) {
+            FixedPos nextPos = pacmanFrom;
+            int32_t speed = 2 * FixedPos::ONE;
+
+            switch (pacman.GetDirection()) {
+            case UP:    nextPos.y -= speed; break;
+            case DOWN:  nextPos.y += speed; break;
+            case LEFT:  nextPos.x -= speed; break;
+            case RIGHT: nextPos.x += speed; break;
+            }
+
+            if (maze.isWalkable(nextPos))
+                pacman.Move(pacman.GetDirection(), maze);
+            else if (maze.isWall(pacman.GetPosition()))
+                pacman.Stop(pacman.GetDirection());
+
+            pacman.Update();  // Only animate when active
+        }
+        pacmanTo = FixedPos::fromPixels(pacman.GetPosition());
+
+        // Walking never takes him backwards; the tunnel's wrap does
+        switch (heading) {
+        case UP:    pacmanJumped = pacmanTo.y > pacmanFrom.y; break;
+        case DOWN:  pacmanJumped = pacmanTo.y < pacmanFrom.y; break;
+        case LEFT:  pacmanJumped = pacmanTo.x > pacmanFrom.x; break;
+        case RIGHT: pacmanJumped = pacmanTo.x < pacmanFrom.x; break;
+        default:    pacmanJumped = false; break;
+        }
+
+        // Food along the way is eaten further down, in order with the ghosts
+        // he runs into. Through the tunnel there is no way, only where he
+        // comes out.
+        maze.sweepFood(pacmanJumped ? pacmanTo : pacmanFrom, pacmanTo, foodHits);
+
+        // Update ghosts in two phases. Deciding and moving only touches the ghost
+        // itself and reads the maze, so it runs as jobs, in parallel when there
+        // are enough ghosts (see jobs.h). Everything shared - food, collisions,
+        // score, lives, blinking - is then committed on this thread in order,
+        // so the outcome is the same however the jobs were split.
+        size_t count = min(ghosts.size(), ghostsBlinking.size());
+        Vector2i pacmanTile = maze.getCell(pacmanTo);
+        aiLod.beginTick(ghosts.size());
+        ghostPlans.assign(count, PLAN_NONE);
+        ghostFrom.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            ghosts[i]->reseed((seed + tick) * 2654435761u + static_cast<uint32_t>(i));
+            ghostFrom[i] = ghosts[i]->GetFixedPosition();
+            ghosts[i]->clearJumped();
+            if (ghostsBlinking[i] || ghostsReturnToSpawn[i]) continue;
+
+            // Far from Pacman only every few ticks; he can't reach it in between
+            AiLodScheduler::Level lod = aiLod.classify(i, maze.getCell(ghostFrom[i]), pacmanTile);
+            if (lod == AiLodScheduler::ASLEEP) ghostPlans[i] = PLAN_ASLEEP;
+            else if (lod == AiLodScheduler::REDUCED && !AiLodScheduler::isFullTick(i, tick)) ghostPlans[i] = PLAN_EXTRAPOLATE;
+            else ghostPlans[i] = PLAN_FULL;
+        }
+
+        JobSystem::RangeJob think = [this](size_t begin, size_t end) {
+            const Maze& board = maze;   // shared by the jobs, so only read
+            for (size_t i = begin; i < end; i++) {
+                uint8_t& plan = ghostPlans[i];
+                if (plan == PLAN_EXTRAPOLATE) {
+                    // A ghost that has to decide gets its full update after all
+                    plan = ghosts[i]->extrapolate(board) ? PLAN_EXTRAPOLATED : PLAN_FULL;
+                    if (plan == PLAN_EXTRAPOLATED) continue;
+                }
+                if (plan == PLAN_FULL) ghosts[i]->updateAutonomous(board);
+            }
+        };
+        if (jobs) jobs->parallelFor(count, GHOST_GRAIN, think);
+        else think(0, count);
+
+        // Which ghosts Pacman touched during the step, and at what point. Only
+        // ghosts updated in full can be near enough (ailod.h).
+        contacts.clear();
+        for (size_t i = 0; i < count; i++) {
+            if (ghostPlans[i] != PLAN_FULL) continue;
+            int32_t at = ghosts[i]->sweptCollision(ghostFrom[i], pacmanFrom, pacmanTo, pacmanJumped);
+            if (at >= 0) contacts.push_back({ at, static_cast<uint32_t>(i) });
+        }
+        sort(contacts.begin(), contacts.end(), [](const GhostContact& a, const GhostContact& b) {
+            return a.at != b.at ? a.at < b.at : a.ghost < b.ghost;
+        });
+
+        // Food and ghosts in the order Pacman reached them, food first where
+        // they tie. An energizer only saves him from ghosts he meets after it;
+        // nothing after a lost life happens.
+        size_t nextFood = 0;
+        for (size_t c = 0; c <= contacts.size() && !events.lifeLost; c++) {
+            int32_t contactAt = c < contacts.size() ? contacts[c].at : Maze::SWEEP_END + 1;
+            while (nextFood < foodHits.size() && foodHits[nextFood].at <= contactAt) {
+                eatFood(foodHits[nextFood++].tile, events);
+            }
+            if (c == contacts.size()) break;
+
+            size_t i = contacts[c].ghost;
+            if (superMode) {
+                // In super mode, ghost gets eaten
+                score += 200;
+                ghostsBlinking[i] = true;
+                ghostEatenTick[i] = tick;
+                scheduleBlink(i);
+                aiLod.wakeAll();
+            }
+            else {
+                // Normal mode - Pacman loses a life
+                lives--;
+                events.lifeLost = true;
+                resetAfterLifeLost();
+            }
+        }
+
+        for (size_t i = 0; i < count && !events.lifeLost; i++) {
+            // Blinking ghosts only animate, their blink timer takes them back
+            if (ghostPlans[i] == PLAN_NONE) {
+                ghosts[i]->Update(dt);
+            }
+            else if (ghostPlans[i] == PLAN_ASLEEP || ghostPlans[i] == PLAN_EXTRAPOLATED) {
+                aiLod.deferred(i, dt, ghostPlans[i] == PLAN_EXTRAPOLATED);
+            }
+            else {
+                ghosts[i]->Update(aiLod.takeFull(i, dt));
+            }
+        }
+
+        // Check if all food has been eaten
+        if (!(maze.foodremains())) {
+            events.won = true;
+        }
+
+        return events;
+    }
+
+    void resetAfterLifeLost() {
+        float cellSize = Maze::getCellSize();
+
+        // Reset ghost positions to their initial spawn positions
+        for (size_t j = 0; j < ghosts.size(); j++) {
+            // Get the ghost's spawn position; line-ups longer than the four
+            // spawns share them in turn, as in startRound
+            Vector2i spawnPos = maze.getGhost(static_cast<char>('0' + j % 4));
+
+            ghosts[j]->SetPosition(
+                (spawnPos.x * cellSize + cellSize / 2) + 20,
+                (spawnPos.y * cellSize + cellSize / 2) + 20
+            );
+
+            // Reset ghost state if needed
+            ghostsBlinking[j] = false;
+            cancelTimer(ghostBlinkTimers[j]);
+            ghostsReturnToSpawn[j] = false;
+            ghosts[j]->setColor(originalGhostColors[j]);  // Restore original color
+        }
+
+        // Reset Pacman position after losing a life
+        pacman.SetPosition(pacmanStartPos.x, pacmanStartPos.y);
+        aiLod.reset(ghosts.size());
+        aiLod.wakeAll();
+    }
+
+    // Maze, ghosts and Pacman in their current state
+    void draw(RenderQueue& queue) {
+        maze.draw(queue);
+        for (auto g : ghosts) {
+            queue.submit(g->getSprite(), LAYER_GHOSTS);
+        }
+        queue.submit(pacman.getSprite(), LAYER_PACMAN);
+    }
+
+    // Same, through a camera following Pacman: tiles and sprites outside its
+    // cull rect are skipped and counted in stats
+    void draw(RenderQueue& queue, Camera& camera, CullStats& stats) {
+        camera.follow(pacman.GetPosition(), maze.getBounds());
+        FloatRect cull = camera.cullRect();
+        maze.draw(queue, cull, &stats);
+        for (auto g : ghosts) {
+            submitCulled(queue, g->getSprite(), LAYER_GHOSTS, cull, stats);
+        }
+        submitCulled(queue, pacman.getSprite(), LAYER_PACMAN, cull, stats);
+    }
+
+    static void submitCulled(RenderQueue& queue, const Sprite& sprite, int16_t layer, const FloatRect& cull, CullStats& stats) {
+        if (sprite.getGlobalBounds().intersects(cull)) {
+            queue.submit(sprite, layer);
+            stats.spritesDrawn++;
+        }
+        else {
+            stats.spritesCulled++;
+        }
+    }
+
+    // Plain-data snapshot of the round (see gamestate.h), with the food of a
+    // maze too big for its planes in food
+    void saveState(GameState& state, PelletPlane& food) {
+        state.clear();
+        state.tick = tick;
+        maze.saveState(state, food);
+
+        Vector2f pacPos = pacman.GetPosition();
+        state.pacmanX = pacPos.x;
+        state.pacmanY = pacPos.y;
+        state.pacmanDirection = static_cast<uint8_t>(pacman.GetDirection());
+        state.pacmanFrozen = pacmanFrozen;
+
+        state.superMode = superMode;
+        state.score = score;
+        state.lives = lives;
+        state.superModeTimer = superModeRemaining();
+        state.gameTimer = gameTimer;
+        state.nextFreezeTime = timers.isPending(nextFreeze)
+            ? gameTimer + static_cast<float>(timers.remaining(nextFreeze)) / TimerWheel::TICK_RATE : 0.0f;
+        state.freezeStart = freezeStart;
+
+        state.ghostCount = static_cast<uint8_t>(min<size_t>(ghosts.size(), GameState::MAX_GHOSTS));
+        for (int i = 0; i < state.ghostCount; i++) {
+            ghosts[i]->saveState(state.ghosts[i]);
+            if (i < static_cast<int>(ghostsBlinking.size())) {
+                state.ghostsBlinking[i] = ghostsBlinking[i];
+                state.ghostBlinkTimers[i] = ghostsBlinking[i]
+                    ? static_cast<float>(tick - ghostEatenTick[i]) / TimerWheel::TICK_RATE : 0.0f;
+            }
+        }
+    }
+
+    // Only snapshots of the current maze and ghost line-up can be loaded back
+    bool loadState(const GameState& state, const PelletPlane& food) {
+        if (!maze.canLoad(state, food))
+            return false;
+        if (state.ghostCount != min<size_t>(ghosts.size(), GameState::MAX_GHOSTS))
+            return false;
+        for (int i = 0; i < state.ghostCount; i++) {
+            if (state.ghosts[i].kind != ghosts[i]->kind())
+                return false;
+        }
+
+        // Timers are saved as time left and scheduled again from the
+        // snapshot's tick
+        tick = state.tick;
+        timers.reset(tick);
+        superModeEnd = nextFreeze = freezeEnd = 0;
+        for (TimerWheel::TimerId& id : ghostBlinkTimers) {
+            id = 0;
+        }
+        maze.loadState(state, food);
+
+        pacman.SetPosition(state.pacmanX, state.pacmanY);
+        pacman.SetDirection(static_cast<Direction>(state.pacmanDirection));
+        pacmanFrozen = state.pacmanFrozen != 0;
+
+        superMode = state.superMode != 0;
+        score = state.score;
+        lives = state.lives;
+        gameTimer = state.gameTimer;
+        freezeStart = state.freezeStart;
+        if (superMode) superModeEnd = timers.schedule(TimerWheel::ticksFor(state.superModeTimer), [this](uint32_t) { endSuperMode(); });
+        scheduleFreeze(TimerWheel::ticksFor(state.nextFreezeTime - gameTimer));
+        if (pacmanFrozen) scheduleUnfreeze(TimerWheel::ticksFor(freezeDuration - (gameTimer - freezeStart)));
+
+        for (int i = 0; i < state.ghostCount; i++) {
+            ghosts[i]->loadState(state.ghosts[i]);
+            if (i < static_cast<int>(ghostsBlinking.size())) {
+                ghostsBlinking[i] = state.ghostsBlinking[i] != 0;
+                ghostEatenTick[i] = tick - TimerWheel::ticksFor(state.ghostBlinkTimers[i]);
+            }
+        }
+        // Ghosts past GameState::MAX_GHOSTS keep blinking from when they were eaten
+        for (size_t i = 0; i < ghosts.size() && i < ghostsBlinking.size(); i++) {
+            if (ghostsBlinking[i]) scheduleBlink(i);
+        }
+        aiLod.reset(ghosts.size());
+        return true;
+    }
+};
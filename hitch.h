@@ -0,0 +1,164 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include "logger.h"
+
+// Hitch detector.
+//
+// The window thread brackets every frame with beginFrame()/endFrame(). Inside
+// the frame HITCH_SCOPE("draw") times the rest of the enclosing block and
+// HITCH_EVENT("scene change") marks a one-off happening. A frame whose work
+// runs over budget is logged with every scope and event it contained, so a
+// spike can be pinned on a glyph page upload or a file open instead of guessed
+// at. Frames under budget cost a few clock reads and are thrown away. Reports
+// go to LOG_HITCH, which isn't rate limited, so hitches in a burst all show.
+//
+// Only the work between beginFrame() and endFrame() counts; the frame pacer's
+// sleep and a static scene's waitEvent happen outside it. Window thread only,
+// scopes and events outside a frame are ignored.
+
+class HitchDetector {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const int MAX_SCOPES = 48;     // later scopes in a frame are not recorded
+    static const int MAX_EVENTS = 16;
+
+private:
+    struct ScopeRecord {
+        const char* name;
+        uint32_t startMicros;             // from the start of the frame
+        uint32_t durationMicros;
+        uint8_t depth;
+    };
+
+    struct EventRecord {
+        const char* name;
+        uint32_t micros;
+    };
+
+    ScopeRecord scopes[MAX_SCOPES];
+    int scopeCount = 0;
+    int depth = 0;
+    EventRecord events[MAX_EVENTS];
+    int eventCount = 0;
+
+    bool inFrame = false;
+    Clock::time_point frameStart;
+    uint64_t frame = 0;
+    double budgetMicros = 1000000.0 / 60;
+    double lastFrameMicros = 0;
+    double worstMicros = 0;
+    uint64_t hitches = 0;
+
+    HitchDetector() {}
+
+    uint32_t sinceFrameStart() const {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - frameStart).count());
+    }
+
+    void report(double frameMicros) const {
+        LOG_WARN(LOG_HITCH, "Hitch in frame %llu: %.2f ms of work, budget %.2f ms",
+            static_cast<unsigned long long>(frame), frameMicros / 1000.0, budgetMicros / 1000.0);
+        // Scopes that took a tenth of a millisecond or more, in the order they started
+        for (int i = 0; i < scopeCount; ++i) {
+            const ScopeRecord& scope = scopes[i];
+            if (scope.durationMicros < 100) continue;
+            LOG_WARN(LOG_HITCH, "  %*s%s %.2f ms at +%.2f ms", scope.depth * 2, "", scope.name,
+                scope.durationMicros / 1000.0, scope.startMicros / 1000.0);
+        }
+        for (int i = 0; i < eventCount; ++i) {
+            LOG_WARN(LOG_HITCH, "  event %s at +%.2f ms", events[i].name, events[i].micros / 1000.0);
+        }
+    }
+
+public:
+    static HitchDetector& instance() {
+        static HitchDetector detector;
+        return detector;
+    }
+
+    HitchDetector(const HitchDetector&) = delete;
+    HitchDetector& operator=(const HitchDetector&) = delete;
+
+    // Frame work allowed before it counts as a hitch, usually the pacer's period
+    void setBudgetMicros(double micros) { budgetMicros = micros; }
+    double getBudgetMicros() const { return budgetMicros; }
+
+    void beginFrame() {
+        inFrame = true;
+        frameStart = Clock::now();
+        scopeCount = 0;
+        depth = 0;
+        eventCount = 0;
+        frame++;
+    }
+
+    // Returns the frame's work time in microseconds
+    double endFrame() {
+        if (!inFrame) return 0;
+        inFrame = false;
+        double frameMicros = std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count();
+        lastFrameMicros = frameMicros;
+        if (frameMicros > worstMicros) worstMicros = frameMicros;
+        if (frameMicros > budgetMicros) {
+            hitches++;
+            report(frameMicros);
+        }
+        return frameMicros;
+    }
+
+    // Index to hand back to endScope, -1 if the scope isn't recorded
+    int beginScope(const char* name) {
+        if (!inFrame) return -1;
+        depth++;
+        if (scopeCount == MAX_SCOPES) return -1;
+        ScopeRecord& scope = scopes[scopeCount];
+        scope.name = name;
+        scope.startMicros = sinceFrameStart();
+        scope.durationMicros = 0;
+        scope.depth = static_cast<uint8_t>(depth - 1);
+        return scopeCount++;
+    }
+
+    void endScope(int index) {
+        if (!inFrame) return;
+        depth--;
+        if (index < 0) return;
+        scopes[index].durationMicros = sinceFrameStart() - scopes[index].startMicros;
+    }
+
+    void event(const char* name) {
+        if (!inFrame || eventCount == MAX_EVENTS) return;
+        events[eventCount].name = name;
+        events[eventCount].micros = sinceFrameStart();
+        eventCount++;
+    }
+
+    void resetStats() {
+        worstMicros = 0;
+        hitches = 0;
+    }
+
+    uint64_t getHitches() const { return hitches; }
+    double getWorstMicros() const { return worstMicros; }
+    double getLastFrameMicros() const { return lastFrameMicros; }
+};
+
+class HitchScope {
+private:
+    int index;
+
+public:
+    explicit HitchScope(const char* name) : index(HitchDetector::instance().beginScope(name)) {}
+    ~HitchScope() { HitchDetector::instance().endScope(index); }
+
+    HitchScope(const HitchScope&) = delete;
+    HitchScope& operator=(const HitchScope&) = delete;
+};
+
+#define HITCH_CONCAT_INNER(a, b) a##b
+#define HITCH_CONCAT(a, b) HITCH_CONCAT_INNER(a, b)
+#define HITCH_SCOPE(name) HitchScope HITCH_CONCAT(hitchScope, __LINE__)(name)
+#define HITCH_EVENT(name) HitchDetector::instance().event(name)
@@ -0,0 +1,180 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job system.
+//
+// parallelFor cuts [0, count) into pieces of at most grain items and deals them
+// out in contiguous blocks, one block per queue: one queue per worker thread
+// plus one for the calling thread, which works too instead of waiting. Each
+// thread takes from the back of its own queue; a thread that runs dry steals
+// from the front of the others', so a piece that turns out slow doesn't hold
+// the rest back. Idle workers sleep on a condition variable until the next
+// parallelFor.
+//
+// Which thread runs which piece is not deterministic. Jobs must only write to
+// their own items and read what nobody writes during the call; then the result
+// is the same for any worker count, including none. GameWorld's ghost AI is
+// the user (see GameWorld::update), bench_jobs measures how it scales.
+
+class JobSystem {
+public:
+    typedef std::function<void(size_t, size_t)> RangeJob;   // runs items [begin, end)
+
+    struct Stats {
+        uint64_t pieces = 0;
+        uint64_t steals = 0;
+    };
+
+private:
+    struct Task {
+        const RangeJob* job;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t>* pending;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;   // [0] is the calling thread's
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<uint64_t> posted;                  // parallelFor calls so far, sleepers wait for it to move
+    std::atomic<bool> stopping;
+
+    std::atomic<uint64_t> pieces;
+    std::atomic<uint64_t> steals;
+
+    bool popOwn(size_t queue, Task& task) {
+        Queue& own = *queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.tasks.empty()) return false;
+        task = own.tasks.back();
+        own.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task) {
+        for (size_t k = 1; k < queues.size(); ++k) {
+            Queue& victim = *queues[(thief + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void execute(const Task& task) {
+        (*task.job)(task.begin, task.end);
+        pieces.fetch_add(1, std::memory_order_relaxed);
+        task.pending->fetch_sub(1, std::memory_order_release);
+    }
+
+    void workerLoop(size_t queue) {
+        while (!stopping.load(std::memory_order_acquire)) {
+            uint64_t seen = posted.load(std::memory_order_acquire);
+            Task task;
+            if (popOwn(queue, task) || steal(queue, task)) {
+                execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [&] {
+                return stopping.load(std::memory_order_relaxed) || posted.load(std::memory_order_relaxed) != seen;
+            });
+        }
+    }
+
+public:
+    // Workers on top of the calling thread; 0 runs everything on the caller
+    explicit JobSystem(int workers) : posted(0), stopping(false), pieces(0), steals(0) {
+        workers = std::max(0, workers);
+        for (int i = 0; i <= workers; ++i) {
+            queues.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+        for (int i = 1; i <= workers; ++i) {
+            threads.push_back(std::thread([this, i] { workerLoop(static_cast<size_t>(i)); }));
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true, std::memory_order_release);
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads) thread.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // The window and simulation threads keep a core each
+    static int defaultWorkers() {
+        return std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 2);
+    }
+
+    int getWorkerCount() const { return static_cast<int>(threads.size()); }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.pieces = pieces.load(std::memory_order_relaxed);
+        stats.steals = steals.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // Run job over [0, count) and return once all of it ran. Small ranges and
+    // a system without workers run inline. One caller at a time.
+    void parallelFor(size_t count, size_t grain, const RangeJob& job) {
+        if (count == 0) return;
+        grain = std::max<size_t>(1, grain);
+        if (threads.empty() || count <= grain) {
+            job(0, count);
+            return;
+        }
+
+        size_t pieceCount = (count + grain - 1) / grain;
+        std::atomic<size_t> pending(pieceCount);
+        size_t queueCount = queues.size();
+        for (size_t q = 0; q < queueCount; ++q) {
+            size_t first = pieceCount * q / queueCount;
+            size_t last = pieceCount * (q + 1) / queueCount;
+            if (first == last) continue;
+            std::lock_guard<std::mutex> lock(queues[q]->mutex);
+            // Pushed in reverse, so popping from the back goes front to back
+            for (size_t piece = last; piece-- > first;) {
+                Task task = { &job, piece * grain, std::min(count, (piece + 1) * grain), &pending };
+                queues[q]->tasks.push_back(task);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            posted.fetch_add(1, std::memory_order_release);
+        }
+        wake.notify_all();
+
+        // The caller runs its own block, then helps with the others
+        while (pending.load(std::memory_order_acquire) != 0) {
+            Task task;
+            if (popOwn(0, task) || steal(0, task)) execute(task);
+            else std::this_thread::yield();
+        }
+    }
+};
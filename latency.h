@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Input-to-photon latency instrumentation (F4 in game).
+//
+// Every key press is stamped three times: when the window thread polled it,
+// when the simulation tick that applied it started, and when display() returned
+// for the first frame that drew that tick or a later one. The three intervals
+// go into millisecond histograms that are written to latency_report.txt at the
+// end of each round.
+//
+// display() returning is the closest this side of the driver gets to photons;
+// scan-out and the panel add a roughly constant amount on top.
+
+struct InputTrace {
+    uint64_t polledMicros;    // key event polled (or sampled, for late-latched input)
+    uint64_t appliedMicros;   // start of the tick that applied it
+    uint32_t tick;            // that tick
+    uint8_t lateLatched;
+};
+
+class LatencyHistogram {
+public:
+    static const int BUCKET_MICROS = 1000;
+    static const int BUCKETS = 100;       // the last one also takes everything slower
+
+private:
+    uint32_t counts[BUCKETS];
+    uint64_t samples;
+    uint64_t totalMicros;
+    uint32_t maxMicros;
+
+public:
+    LatencyHistogram() { reset(); }
+
+    void reset() {
+        std::fill(counts, counts + BUCKETS, 0u);
+        samples = 0;
+        totalMicros = 0;
+        maxMicros = 0;
+    }
+
+    void add(uint64_t micros) {
+        int bucket = static_cast<int>(std::min<uint64_t>(micros / BUCKET_MICROS, BUCKETS - 1));
+        counts[bucket]++;
+        samples++;
+        totalMicros += micros;
+        maxMicros = std::max(maxMicros, static_cast<uint32_t>(std::min<uint64_t>(micros, UINT32_MAX)));
+    }
+
+    uint64_t count() const { return samples; }
+    double meanMillis() const { return samples ? totalMicros / 1000.0 / samples : 0.0; }
+
+    // Upper edge of the bucket holding the p-th sample, in milliseconds
+    double percentileMillis(double p) const {
+        if (samples == 0) return 0.0;
+        uint64_t rank = static_cast<uint64_t>(p * (samples - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return (i + 1) * BUCKET_MICROS / 1000.0;
+        }
+        return maxMicros / 1000.0;
+    }
+
+    void print(FILE* out, const char* title) const {
+        std::fprintf(out, "%s: %llu samples, mean %.2f ms, p50 %.0f ms, p95 %.0f ms, p99 %.0f ms, max %.2f ms\n",
+            title, static_cast<unsigned long long>(samples), meanMillis(), percentileMillis(0.50),
+            percentileMillis(0.95), percentileMillis(0.99), maxMicros / 1000.0);
+        uint32_t peak = *std::max_element(counts, counts + BUCKETS);
+        for (int i = 0; i < BUCKETS; ++i) {
+            if (counts[i] == 0) continue;
+            int bar = peak ? static_cast<int>(40.0 * counts[i] / peak + 0.5) : 0;
+            std::fprintf(out, "  %3d%s ms %7u %s\n", i, i == BUCKETS - 1 ? "+" : " ", counts[i],
+                std::string(std::max(bar, 1), '#').c_str());
+        }
+    }
+};
+
+// Window thread side: matches applied inputs to the frame that first shows them
+class LatencyProbe {
+private:
+    std::vector<InputTrace> waiting;
+    uint64_t lateLatched = 0;
+
+public:
+    LatencyHistogram pollToTick;
+    LatencyHistogram tickToDisplay;
+    LatencyHistogram pollToDisplay;
+
+    LatencyProbe() { waiting.reserve(64); }
+
+    // An input the simulation applied
+    void applied(const InputTrace& trace) {
+        waiting.push_back(trace);
+    }
+
+    // display() returned at micros with the frame showing tick
+    void displayed(uint32_t tick, uint64_t micros) {
+        size_t kept = 0;
+        for (const InputTrace& trace : waiting) {
+            if (trace.tick > tick) {
+                waiting[kept++] = trace;
+                continue;
+            }
+            pollToTick.add(trace.appliedMicros - trace.polledMicros);
+            tickToDisplay.add(micros - trace.appliedMicros);
+            pollToDisplay.add(micros - trace.polledMicros);
+            if (trace.lateLatched) lateLatched++;
+        }
+        waiting.resize(kept);
+    }
+
+    void reset() {
+        waiting.clear();
+        lateLatched = 0;
+        pollToTick.reset();
+        tickToDisplay.reset();
+        pollToDisplay.reset();
+    }
+
+    // p50 and p99 of the whole path, for the debug overlay
+    std::string summary() const {
+        char text[64];
+        std::snprintf(text, sizeof(text), "P50 %.0f MS  P99 %.0f MS",
+            pollToDisplay.percentileMillis(0.50), pollToDisplay.percentileMillis(0.99));
+        return text;
+    }
+
+    bool writeReport(const std::string& path) const {
+        FILE* out = std::fopen(path.c_str(), "w");
+        if (!out) return false;
+        std::fprintf(out, "Input latency, %llu presses (%llu late-latched)\n\n",
+            static_cast<unsigned long long>(pollToDisplay.count()), static_cast<unsigned long long>(lateLatched));
+        pollToTick.print(out, "poll -> tick");
+        std::fputc('\n', out);
+        tickToDisplay.print(out, "tick -> display");
+        std::fputc('\n', out);
+        pollToDisplay.print(out, "poll -> display");
+        return std::fclose(out) == 0;
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "gamestate.h"
+#include "logger.h"
+#include "maze.h"
+#include "mazegen.h"
+
+// Level campaign and background level loading.
+//
+// A round is a campaign of LEVEL_COUNT levels. Level 1 is the stock maze, level
+// N is read from levelN.txt (the Maze format, one row per line). Without a
+// playable file the level is generated (mazegen.h) at the stock size, seeded
+// with the level number, so every campaign sees the same mazes. Score and
+// lives carry over; clearing the last level wins the round.
+//
+// While level N is played, LevelPreloader builds level N+1 on its own thread:
+// reads the file, checks that it is playable, and constructs the Maze with its
+// padded tile map, food count and wall mesh. Clearing the level then only has
+// to swap the finished maze with the preloaded one (Maze::swap), which is a
+// handful of pointer swaps instead of a load on the frame the last pellet was
+// eaten.
+
+struct Level {
+    int number = 0;
+    std::string source;            // file the layout came from, "stock" or "generated"
+    std::unique_ptr<Maze> maze;
+    double loadMillis = 0;         // time the loader thread spent building it
+};
+
+class LevelCampaign {
+public:
+    static const int LEVEL_COUNT = 5;
+    static const int GENERATED_WIDTH = 21;    // fits the window like the stock maze
+    static const int GENERATED_HEIGHT = 21;
+
+    static std::string fileName(int number) {
+        return "level" + std::to_string(number) + ".txt";
+    }
+
+    // Rows of a level file, trailing carriage returns and blank lines dropped
+    static bool readRows(const std::string& path, std::vector<std::string>& rows) {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        rows.clear();
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            rows.push_back(line);
+        }
+        while (!rows.empty() && rows.back().find_first_not_of(' ') == std::string::npos) rows.pop_back();
+        return !rows.empty();
+    }
+
+    // A level is playable when it fits a snapshot, has one Pacman and all four
+    // ghost spawns, and every pellet can be reached from Pacman's start.
+    // Returns an empty string if so, otherwise what is wrong.
+    static std::string validate(const std::vector<std::string>& rows) {
+        if (static_cast<int>(rows.size()) > GameState::MAX_HEIGHT || MazeLayout::width(rows) > GameState::MAX_WIDTH)
+            return "larger than " + std::to_string(GameState::MAX_WIDTH) + "x" + std::to_string(GameState::MAX_HEIGHT);
+
+        int pacmen = 0, food = 0;
+        bool spawns[4] = { false, false, false, false };
+        for (const std::string& row : rows) {
+            for (char c : row) {
+                if (c == 'P') pacmen++;
+                else if (c >= '0' && c <= '3') spawns[c - '0'] = true;
+                else if (MazeLayout::isFood(c)) food++;
+            }
+        }
+        if (pacmen != 1) return "needs exactly one P";
+        for (int i = 0; i < 4; ++i) {
+            if (!spawns[i]) return std::string("missing ghost spawn ") + static_cast<char>('0' + i);
+        }
+        if (food == 0) return "no food";
+
+        int unreachable = MazeLayout::unreachableFood(rows);
+        if (unreachable > 0) return std::to_string(unreachable) + " pellets can't be reached";
+        return std::string();
+    }
+
+    // Build a level, on whatever thread calls it
+    static std::unique_ptr<Level> load(int number) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::unique_ptr<Level> level(new Level());
+        level->number = number;
+
+        std::vector<std::string> rows;
+        if (number == 1) {
+            level->maze.reset(new Maze());
+            level->source = "stock";
+        }
+        else if (readRows(fileName(number), rows)) {
+            std::string problem = validate(rows);
+            if (problem.empty()) {
+                level->source = fileName(number);
+                level->maze.reset(new Maze(rows));
+            }
+            else {
+                LOG_WARN(LOG_MAZE, "%s is not playable (%s), generating the level", fileName(number).c_str(), problem.c_str());
+            }
+        }
+        if (!level->maze) {
+            rows = MazeGenerator::generate(GENERATED_WIDTH, GENERATED_HEIGHT, static_cast<uint32_t>(number));
+            level->maze.reset(new Maze(rows));
+            level->source = "generated";
+        }
+
+        level->loadMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return level;
+    }
+};
+
+// Builds one level at a time in the background
+class LevelPreloader {
+private:
+    std::thread worker;
+    std::unique_ptr<Level> loaded;        // written by the worker, read after join
+    std::atomic<bool> ready;
+    int requested = 0;
+
+public:
+    LevelPreloader() : ready(false) {}
+    ~LevelPreloader() { cancel(); }
+
+    LevelPreloader(const LevelPreloader&) = delete;
+    LevelPreloader& operator=(const LevelPreloader&) = delete;
+
+    // Start building level number, dropping whatever was loaded before
+    void request(int number) {
+        cancel();
+        requested = number;
+        worker = std::thread([this, number] {
+            loaded = LevelCampaign::load(number);
+            ready.store(true, std::memory_order_release);
+        });
+    }
+
+    int pending() const { return requested; }
+    bool isReady() const { return ready.load(std::memory_order_acquire); }
+
+    // The requested level. Blocks until the worker is done if it isn't yet, and
+    // reports how long that took in stallMillis. Null if nothing was requested.
+    std::unique_ptr<Level> take(double& stallMillis) {
+        stallMillis = 0;
+        if (!worker.joinable()) return nullptr;
+        bool waited = !isReady();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        worker.join();
+        if (waited)
+            stallMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ready.store(false, std::memory_order_relaxed);
+        requested = 0;
+        return std::move(loaded);
+    }
+
+    // Wait out a running load and throw it away
+    void cancel() {
+        if (worker.joinable()) worker.join();
+        loaded.reset();
+        ready.store(false, std::memory_order_relaxed);
+        requested = 0;
+    }
+};
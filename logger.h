@@ -0,0 +1,264 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+// Asynchronous logger for the game thread.
+//
+// LOG_DEBUG(LOG_MAZE, "Super mode ending in %d seconds!", n) formats the message
+// straight into a slot of a fixed ring buffer and returns; a background thread
+// drains the ring and does the actual (slow, flushed) console I/O. Producers
+// never lock and never allocate. When the ring is full the message is dropped
+// and counted instead of blocking the frame.
+//
+// Levels below LOG_MIN_LEVEL expand to nothing at compile time, arguments
+// included. Each category is also rate limited (LOG_RATE_LIMIT messages per
+// second by default), so a message sitting in a per-frame path can't flood the
+// console; the writer reports how many were suppressed. LOG_HITCH isn't: a
+// hitch report is a burst of lines, and the second hitch in a row is the one
+// that matters.
+
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF   5
+
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#ifndef LOG_RATE_LIMIT
+#define LOG_RATE_LIMIT 20
+#endif
+
+enum LogCategory : uint8_t {
+    LOG_GAME,
+    LOG_MAZE,
+    LOG_GHOST,
+    LOG_AUDIO,
+    LOG_TOOLS,
+    LOG_HITCH,                            // hitch reports (hitch.h), not rate limited
+    LOG_CATEGORY_COUNT
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOGGER_PRINTF_FORMAT __attribute__((format(printf, 4, 5)))
+#else
+#define LOGGER_PRINTF_FORMAT
+#endif
+
+class Logger {
+public:
+    static const int CAPACITY = 1024;     // power of two
+    static const int TEXT_SIZE = 120;     // longer messages are truncated
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        uint64_t micros;
+        uint8_t level;
+        uint8_t category;
+        char text[TEXT_SIZE];
+    };
+
+    struct RateWindow {
+        std::atomic<int64_t> second;
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> suppressed;
+    };
+
+    Slot slots[CAPACITY];
+    std::atomic<uint64_t> enqueuePos;
+    uint64_t dequeuePos;                  // writer thread only
+    std::atomic<uint64_t> dropped;
+    RateWindow rate[LOG_CATEGORY_COUNT];
+    std::atomic<uint32_t> rateLimit[LOG_CATEGORY_COUNT];
+
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<FILE*> output;
+    std::atomic<bool> stopping;
+    std::thread writer;
+
+    Logger()
+        : enqueuePos(0), dequeuePos(0), dropped(0),
+        startTime(std::chrono::steady_clock::now()), output(stdout), stopping(false)
+    {
+        for (int i = 0; i < CAPACITY; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        for (int c = 0; c < LOG_CATEGORY_COUNT; ++c) {
+            rate[c].second.store(-1, std::memory_order_relaxed);
+            rate[c].count.store(0, std::memory_order_relaxed);
+            rate[c].suppressed.store(0, std::memory_order_relaxed);
+            rateLimit[c].store(c == LOG_HITCH ? 0 : LOG_RATE_LIMIT, std::memory_order_relaxed);
+        }
+        writer = std::thread([this] { run(); });
+    }
+
+    uint64_t nowMicros() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    bool allow(uint8_t category, uint64_t micros) {
+        uint32_t limit = rateLimit[category].load(std::memory_order_relaxed);
+        if (limit == 0) return true;
+
+        RateWindow& window = rate[category];
+        int64_t second = static_cast<int64_t>(micros / 1000000);
+        int64_t current = window.second.load(std::memory_order_relaxed);
+        if (current != second && window.second.compare_exchange_strong(current, second, std::memory_order_relaxed)) {
+            window.count.store(0, std::memory_order_relaxed);
+        }
+        if (window.count.fetch_add(1, std::memory_order_relaxed) < limit) return true;
+        window.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    static const char* levelName(uint8_t level) {
+        static const char* const names[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+        return level < 5 ? names[level] : "?";
+    }
+
+    static const char* categoryName(uint8_t category) {
+        static const char* const names[] = { "game", "maze", "ghost", "audio", "tools", "hitch" };
+        return category < LOG_CATEGORY_COUNT ? names[category] : "?";
+    }
+
+    // Writer thread: print everything that's ready, then the suppression counts
+    bool drain() {
+        FILE* out = output.load(std::memory_order_relaxed);
+        bool wrote = false;
+        for (;;) {
+            Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) break;
+
+            std::fprintf(out, "%10.3f %-5s %-5s %s\n", slot.micros / 1e6, levelName(slot.level),
+                categoryName(slot.category), slot.text);
+            slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+            dequeuePos++;
+            wrote = true;
+        }
+
+        for (int c = 0; c < LOG_CATEGORY_COUNT; ++c) {
+            uint32_t suppressed = rate[c].suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed) {
+                std::fprintf(out, "%10s %-5s %-5s (%u messages suppressed by rate limit)\n", "", "",
+                    categoryName(static_cast<uint8_t>(c)), suppressed);
+                wrote = true;
+            }
+        }
+        uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost) {
+            std::fprintf(out, "%10s %-5s %-5s (%llu messages dropped, log buffer full)\n", "", "", "",
+                static_cast<unsigned long long>(lost));
+            wrote = true;
+        }
+
+        if (wrote) std::fflush(out);
+        return wrote;
+    }
+
+    void run() {
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (!drain()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        drain();
+    }
+
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    ~Logger() {
+        stopping.store(true, std::memory_order_release);
+        if (writer.joinable()) writer.join();
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Messages per second allowed for a category, 0 for unlimited
+    void setRateLimit(LogCategory category, uint32_t perSecond) {
+        rateLimit[category].store(perSecond, std::memory_order_relaxed);
+    }
+
+    void setOutput(FILE* file) {
+        output.store(file, std::memory_order_relaxed);
+    }
+
+    void write(int level, LogCategory category, const char* format, ...) LOGGER_PRINTF_FORMAT {
+        uint64_t micros = nowMicros();
+        if (!allow(category, micros)) return;
+
+        // Claim a slot (bounded multi-producer queue, one sequence number per slot)
+        uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & (CAPACITY - 1)];
+            uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (seq < pos) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->micros = micros;
+        slot->level = static_cast<uint8_t>(level);
+        slot->category = category;
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(slot->text, TEXT_SIZE, format, args);
+        va_end(args);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+};
+
+#define LOG_AT(level, category, ...) Logger::instance().write(level, category, __VA_ARGS__)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(category, ...) LOG_AT(LOG_LEVEL_TRACE, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(category, ...) LOG_AT(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(category, ...) LOG_AT(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(category, ...) LOG_AT(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(category, ...) LOG_AT(LOG_LEVEL_ERROR, category, __VA_ARGS__)
+#else
+#define LOG_ERROR(category, ...) ((void)0)
+#endif
@@ -1,419 +1,695 @@
-#pragma once
-#include <iostream>
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <string>
-#include <cstdlib>
-#include <ctime>
-#include <cmath>
-
-using namespace std;
-using namespace sf;
-
-class Maze {
-private:
-    static const int WIDTH = 23;
-    static const int HEIGHT = 21;
-    static const int CELL_SIZE = 40;
-    static const int WALL_THICKNESS = 9; // Reduced wall thickness for better appearance
-
-    Vector2f offset;
-    vector<string> map;
-    Color wallColor;
-    bool superMode = false;
-    Clock superModeClock;
-    const float superDuration = 12.f;
-    int totalFood = 146;
-
-    const char* mapData[HEIGHT] = {
-        " ###################",
-        " #........#........# ",
-        " #o##.###.#.###.##o# ",
-        " #........0........# ",
-        " #.##.#.#####.#.##.# ",
-        " #....#...#...#....# ",
-        " ####.### # ###.#### ",
-        "    #.#       #.#    ",
-        "#####.# #   # #.#####",
-        "     .  #123#  .     ",
-        "#####.# ##### #.#####",
-        "    #.#       #.#    ",
-        " ####.# ##### #.#### ",
-        " #........#........# ",
-        " #.##.###.#.###.##.# ",
-        " #o.#.....P.....#.o# ",
-        " ##.#.#.#####.#.#.## ",
-        " #....#...#...#....# ",
-        " #.######.#.######.# ",
-        " #.................# ",
-        " ###################"
-    };
-
-public:
-    Maze() {
-        // Default offset position
-        offset = Vector2f(60.f, 40.f);
-
-        // Initialize random wall color, but more aesthetically pleasing
-        srand(static_cast<unsigned>(time(nullptr)));
-        wallColor = Color(20, 80, 200); // Start with a nice blue color
-
-        // Initialize maze
-        reset();
-
-        // Debug message to verify offset values
-        std::cout << "Maze initialized with offset: (" << offset.x << ", " << offset.y << ")" << std::endl;
-    }
-
-
-
-    void setSuperMode(bool mode) {
-        superMode = mode;
-        if (mode) {
-            superModeClock.restart();
-            std::cout << "Super mode activated for " << superDuration << " seconds!" << std::endl;
-        }
-    }
-
-    bool isSuperModeActive() {
-        if (superMode) {
-            float remainingTime = superDuration - superModeClock.getElapsedTime().asSeconds();
-            if (remainingTime <= 0) {
-                superMode = false;
-                std::cout << "Super mode expired!" << std::endl;
-                return false;
-            }
-            // Optional: Print remaining time when it's close to expiring
-            if (remainingTime < 3.0f && static_cast<int>(remainingTime * 10) % 5 == 0) {
-                std::cout << "Super mode ending in " << static_cast<int>(remainingTime + 0.9f) << " seconds!" << std::endl;
-            }
-        }
-        return superMode;
-    }
-
-    float getSuperModeTimeRemaining() const {
-        if (!superMode) return 0.0f;
-        float remainingTime = superDuration - superModeClock.getElapsedTime().asSeconds();
-        return (remainingTime > 0) ? remainingTime : 0.0f;
-    }
-
-    void reset() {
-        map.clear();
-        totalFood = 0;
-        for (int i = 0; i < HEIGHT; ++i) {
-            string row = mapData[i];
-            if (row.length() < WIDTH)
-                row += string(WIDTH - row.length(), ' ');
-            map.push_back(row);
-            for (char c : row) {
-                if (c == '.' || c == 'o')
-                    totalFood++;
-            }
-        }
-    }
-        void draw(RenderWindow& window) 
-        {
-        // Handle super mode color with smooth transition effect
-        Color drawColor;
-        if (isSuperModeActive()) {
-            drawColor = Color::Yellow;
-
-            // Flash effect when super mode is about to expire (last 3 seconds)
-            float remainingTime = getSuperModeTimeRemaining();
-            if (remainingTime < 3.0f) {
-                // Flash between blue and normal color
-                if (static_cast<int>(remainingTime * 10) % 2 == 0) {
-                    drawColor = Color::Blue;
-                }
-                else {
-                    drawColor = Color::Yellow;
-                }
-            }
-        }
-        else {
-            drawColor = Color::Blue;
-        }
-
-        // Draw timer if in super mode
-        if (isSuperModeActive()) {
-            float remainingTime = getSuperModeTimeRemaining();
-            // Create timer bar at the top of the screen
-            RectangleShape timerBar(Vector2f(WIDTH * CELL_SIZE * (remainingTime / superDuration), 10));
-            timerBar.setPosition(offset.x, offset.y - 20);
-            timerBar.setFillColor(Color::Yellow);
-            window.draw(timerBar);
-        }
-
-        // Small rendering adjustment for visual consistency
-        const float renderAdjustX = -7.0f;
-        const float renderAdjustY = 10.0f;
-
-        // Improved maze rendering approach with node-based walls
-        for (int row = 0; row < HEIGHT; ++row) {
-            for (int col = 0; col < WIDTH; ++col) {
-                char tile = map[row][col];
-                float x = offset.x + col * CELL_SIZE + renderAdjustX;
-                float y = offset.y + row * CELL_SIZE + renderAdjustY;
-
-                if (tile == '#') {
-                    // Check wall connections in all four directions
-                    bool wallAbove = (row > 0 && map[row - 1][col] == '#');
-                    bool wallBelow = (row < HEIGHT - 1 && map[row + 1][col] == '#');
-                    bool wallLeft = (col > 0 && map[row][col - 1] == '#');
-                    bool wallRight = (col < WIDTH - 1 && map[row][col + 1] == '#');
-
-                    // Draw a wall node
-                    RectangleShape nodeRect(Vector2f(WALL_THICKNESS, WALL_THICKNESS));
-                    nodeRect.setPosition(x + 10 + CELL_SIZE / 2 - WALL_THICKNESS / 2, y + 10 + CELL_SIZE / 2 - WALL_THICKNESS / 2);
-                    nodeRect.setFillColor(drawColor);
-                    window.draw(nodeRect);
-
-                    // Draw wall connections
-                    if (wallAbove) {
-                        RectangleShape wallLine(Vector2f(WALL_THICKNESS, CELL_SIZE / 2 + WALL_THICKNESS / 2));
-                        wallLine.setPosition(x + 10 + CELL_SIZE / 2 - WALL_THICKNESS / 2, y + 10);
-                        wallLine.setFillColor(drawColor);
-                        window.draw(wallLine);
-                    }
-
-                    if (wallBelow) {
-                        RectangleShape wallLine(Vector2f(WALL_THICKNESS, CELL_SIZE / 2 + WALL_THICKNESS / 2));
-                        wallLine.setPosition(x + 10 + CELL_SIZE / 2 - WALL_THICKNESS / 2, y + 10 + CELL_SIZE / 2);
-                        wallLine.setFillColor(drawColor);
-                        window.draw(wallLine);
-                    }
-
-                    if (wallLeft) {
-                        RectangleShape wallLine(Vector2f(CELL_SIZE / 2 + WALL_THICKNESS / 2, WALL_THICKNESS));
-                        wallLine.setPosition(x + 10, y + 10 + CELL_SIZE / 2 - WALL_THICKNESS / 2);
-                        wallLine.setFillColor(drawColor);
-                        window.draw(wallLine);
-                    }
-
-                    if (wallRight) {
-                        RectangleShape wallLine(Vector2f(CELL_SIZE / 2 + WALL_THICKNESS / 2, WALL_THICKNESS));
-                        wallLine.setPosition(x + 10 + CELL_SIZE / 2, y + 10 + CELL_SIZE / 2 - WALL_THICKNESS / 2);
-                        wallLine.setFillColor(drawColor);
-                        window.draw(wallLine);
-                    }
-                }
-                else if (tile == '.') {
-                    CircleShape dot(CELL_SIZE / 10);
-                    dot.setFillColor(Color::White);
-                    // Center the dot in the cell
-                    dot.setPosition(x + 14 + CELL_SIZE / 2 - CELL_SIZE / 10, y + 10 + CELL_SIZE / 2 - CELL_SIZE / 10);
-                    window.draw(dot);
-                }
-                else if (tile == 'o') {
-                    CircleShape energizer(CELL_SIZE / 5);
-                    energizer.setFillColor(Color::Yellow);
-                    // Center the energizer in the cell
-                    energizer.setPosition(x + 14 + CELL_SIZE / 2 - CELL_SIZE / 5, y + 10 + CELL_SIZE / 2 - CELL_SIZE / 5);
-                    window.draw(energizer);
-                }
-            }
-        }
-    }
-
-
-
-    bool foodremains() const { return totalFood > 0; }
-
-    char getTile(int row, int col) const {
-        if (row >= 0 && row < HEIGHT && col >= 0 && col < WIDTH)
-            return map[row][col];
-        return ' ';
-    }
-
-    // Check if a cell is a wall (same as before)
-    // Check if a cell is a wall (same as before)
-    bool isWall(Vector2f pos) const {
-        Vector2i cell = getCell(pos);
-        return getTile(cell.y, cell.x) == '#';
-    }
-
-    // Check if position is aligned with vertical or horizontal grid lines
-    bool isAlignedWithGrid(Vector2f position) {
-        float cellX = position.x - offset.x;
-        float cellY = position.y - offset.y;
-
-        return (fmod(cellX, CELL_SIZE) < 1.0f || fmod(cellX, CELL_SIZE) > CELL_SIZE - 1.0f ||
-            fmod(cellY, CELL_SIZE) < 1.0f || fmod(cellY, CELL_SIZE) > CELL_SIZE - 1.0f);
-    }
-
-    // Return the nearest grid line intersection point
-    Vector2f getNearestGridIntersection(Vector2f position) {
-        int xLine = static_cast<int>((position.x - offset.x) / CELL_SIZE);
-        int yLine = static_cast<int>((position.y - offset.y) / CELL_SIZE);
-
-        float nearestX = offset.x + xLine * CELL_SIZE;
-        float nearestY = offset.y + yLine * CELL_SIZE;
-
-        return Vector2f(nearestX, nearestY);
-    }
-
-    // Check if movement is valid along the line-based grid
-    bool canMove(Vector2f currentPos, Vector2f direction) {
-        Vector2f targetPos = currentPos + direction;
-
-        Vector2i currentCell = getCell(currentPos);
-        Vector2i targetCell = getCell(targetPos);
-
-        // Disallow movement outside grid
-        if (targetCell.x < 0 || targetCell.x >= WIDTH ||
-            targetCell.y < 0 || targetCell.y >= HEIGHT) {
-            return false;
-        }
-
-        // For horizontal or vertical movement only
-        if (direction.x != 0 && direction.y != 0) {
-            return false; // Disallow diagonal movement
-        }
-
-        // Check for wall in target direction
-        if (getTile(targetCell.y, targetCell.x) == '#') {
-            return false;
-        }
-
-        return true;
-    }
-
-    // Checks if a position lies along a valid walkable line
-    bool isWalkable(Vector2f position) {
-        Vector2i cell = getCell(position);
-        if (cell.y < 0 || cell.y >= HEIGHT || cell.x < 0 || cell.x >= WIDTH)
-            return false;
-
-        return map[cell.y][cell.x] != '#';
-    }
-
-
-
-    bool isFood(Vector2f pos) {
-        Vector2i cell = getCell(pos);
-        Vector2f cellCenter = {
-            offset.x + cell.x * CELL_SIZE + CELL_SIZE / 2.f,
-            offset.y + cell.y * CELL_SIZE + CELL_SIZE / 2.f
-        };
-
-        // Check if the cell contains food
-        if (getTile(cell.y, cell.x) == '.') {
-            // Calculate distance from player center to cell center
-            float distance = sqrt(pow(pos.x - cellCenter.x, 2) + pow(pos.y - cellCenter.y, 2));
-
-            // Use a more appropriate threshold (about 1/3 of cell size)
-            if (distance < CELL_SIZE * 0.4f) {
-                map[cell.y][cell.x] = ' ';
-                totalFood--;
-                return true;
-            }
-        }
-        return false;
-    }
-
-    bool isSuperFood(Vector2f pos) {
-        Vector2i cell = getCell(pos);
-        Vector2f cellCenter = {
-            offset.x + cell.x * CELL_SIZE + CELL_SIZE / 2.f,
-            offset.y + cell.y * CELL_SIZE + CELL_SIZE / 2.f
-        };
-
-        // Check if the cell contains super food
-        if (getTile(cell.y, cell.x) == 'o') {
-            // Calculate distance from player center to cell center
-            float distance = sqrt(pow(pos.x - cellCenter.x, 2) + pow(pos.y - cellCenter.y, 2));
-
-            // Use a more appropriate threshold (about 1/3 of cell size)
-            if (distance < CELL_SIZE * 0.4f) {
-                map[cell.y][cell.x] = ' ';
-                totalFood--;
-                setSuperMode(true);
-                return true;
-            }
-        }
-        return false;
-    }
-
-    // Improved collision detection between entities
-    bool checkCollision(Vector2f pos1, Vector2f pos2, float threshold = 0.5f) {
-        float distance = sqrt(pow(pos1.x - pos2.x, 2) + pow(pos1.y - pos2.y, 2));
-        return distance < CELL_SIZE * threshold;
-    }
-
-    int getFoodCount() const { return totalFood; }
-
-    Vector2f getOffset() const { return offset; }
-
-    // Improved entity-to-maze position alignment
-    Vector2f alignToGrid(Vector2f pos) {
-        Vector2i cell = getCell(pos);
-        return Vector2f(
-            offset.x + cell.x * CELL_SIZE + CELL_SIZE / 2.0f,
-            offset.y + cell.y * CELL_SIZE + CELL_SIZE / 2.0f
-        );
-    }
-    // Get the center of the current cell
-    Vector2f getCellCenter(Vector2f position) {
-        Vector2i cell = getCell(position);
-        return Vector2f(
-            offset.x + cell.x * CELL_SIZE + CELL_SIZE / 2.0f,
-            offset.y + cell.y * CELL_SIZE + CELL_SIZE / 2.0f
-        );
-    }
-    // Convert grid cell coordinates to world position
-    Vector2f cellToPosition(int col, int row) {
-        return Vector2f(
-            offset.x + col * CELL_SIZE + CELL_SIZE / 2.0f,
-            offset.y + row * CELL_SIZE + CELL_SIZE / 2.0f
-        );
-    }
-
-    // Convert world position to perfect grid cell coordinates
-    Vector2i getCell(Vector2f pos) const {
-        int col = static_cast<int>((pos.x - offset.x) / CELL_SIZE);
-        int row = static_cast<int>((pos.y - offset.y) / CELL_SIZE);
-
-        // Ensure values are within bounds
-        col = std::max(0, std::min(col, WIDTH - 1));
-        row = std::max(0, std::min(row, HEIGHT - 1));
-
-        return { col, row };
-    }
-    int getCol(Vector2f pos) const {
-        int col = static_cast<int>((pos.x - offset.x) / CELL_SIZE);
-        return col;
-    }
-    int getRows(Vector2f pos) const {
-        int row = static_cast<int>((pos.y - offset.y) / CELL_SIZE);
-        return row;
-    }
-    static int getCellSize() { return CELL_SIZE; }
-    static int getWidth() { return WIDTH; }
-    static int getHeight() { return HEIGHT; }
-
-    Vector2i getP() const {
-        for (int row = 0; row < HEIGHT; ++row) {
-            for (int col = 0; col < WIDTH; ++col) {
-                if (map[row][col] == 'P')
-                    return { col, row };
-            }
-        }
-        return { -1, -1 };
-    }
-
-    Vector2i getGhost(char ghostId) const {
-        for (int row = 0; row < HEIGHT; ++row) {
-            for (int col = 0; col < WIDTH; ++col) {
-                if (map[row][col] == ghostId) {
-                    return { col, row };
-                }
-            }
-        }
-        return { -1, -1 };  // Return invalid position if not found
-    }
-
-    Vector2i getGhost0() const { return getGhost('0'); }
-    Vector2i getGhost1() const { return getGhost('1'); }
-    Vector2i getGhost2() const { return getGhost('2'); }
-    Vector2i getGhost3() const { return getGhost('3'); }
+#pragma once
+#include <iostream>
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "camera.h"
+#include "fixedpoint.h"
+#include "gamestate.h"
+#include "logger.h"
+#include "mazetables.h"
+#include "renderqueue.h"
+#include "timerwheel.h"
+
+using namespace std;
+using namespace sf;
+
+// A pellet or energizer a step went close enough past to eat (Maze::sweepFood)
+struct FoodHit {
+    Vector2i tile;
+    int32_t at;          // how far along the step, 0 to Maze::SWEEP_END
+};
+
+class Maze {
+private:
+    static const int WIDTH = 23;     // size of the stock map below
+    static const int HEIGHT = 21;
+    static const int CELL_SIZE = 40;
+    static const int WALL_THICKNESS = 9; // Reduced wall thickness for better appearance
+    static const int32_t CELL_UNITS = CELL_SIZE * FixedPos::ONE;
+
+    Vector2f offset;
+    FixedPos origin;         // offset in fixed point, where position queries count tiles from
+    int width = WIDTH;
+    int height = HEIGHT;
+    vector<char> layout;     // width x height tiles as loaded, before anything was eaten
+    vector<char> tiles;      // the same as played; reset() copies layout over it
+    vector<uint8_t> neighbours;    // MazeTables::neighbours of every tile
+    vector<uint32_t> wallPlanes;   // bitplanes of the rows a snapshot holds (mazetables.h)
+    vector<uint32_t> foodPlanes;
+    PelletPlane foodLeft;          // food of a maze too big for those, shared with its snapshots
+    Vector2i pacmanStart;
+    Vector2i ghostStarts[4];
+    int layoutFood = 0;
+    Color wallColor;
+    bool superMode = false;
+    TimerWheel* timers = nullptr;      // the world's, counts down super mode (see setTimers)
+    TimerWheel::TimerId superModeEnd = 0;
+    const float superDuration = 12.f;
+    int totalFood = 0;
+    vector<FloatRect> wallRects;   // wall nodes and connections, built once per layout
+    vector<int> wallCols;          // tile column of each wall rect
+    vector<int> wallRowStart;      // first wall rect of each row, plus one past the last
+
+    // The stock map, compiled into its tables while the game compiles
+    static constexpr const char* STOCK_ROWS[HEIGHT] = {
+        " ###################",
+        " #........#........# ",
+        " #o##.###.#.###.##o# ",
+        " #........0........# ",
+        " #.##.#.#####.#.##.# ",
+        " #....#...#...#....# ",
+        " ####.### # ###.#### ",
+        "    #.#       #.#    ",
+        "#####.# #   # #.#####",
+        "     .  #123#  .     ",
+        "#####.# ##### #.#####",
+        "    #.#       #.#    ",
+        " ####.# ##### #.#### ",
+        " #........#........# ",
+        " #.##.###.#.###.##.# ",
+        " #o.#.....P.....#.o# ",
+        " ##.#.#.#####.#.#.## ",
+        " #....#...#...#....# ",
+        " #.######.#.######.# ",
+        " #.................# ",
+        " ###################"
+    };
+
+    static constexpr CompiledMaze<WIDTH, HEIGHT> STOCK{ STOCK_ROWS };
+    static_assert(STOCK.longestRow <= WIDTH, "a stock map row is wider than Maze::WIDTH");
+    static_assert(WIDTH <= GameState::MAX_WIDTH && HEIGHT <= GameState::MAX_HEIGHT, "the stock map doesn't fit a snapshot");
+    static_assert(STOCK.pacmen == 1, "the stock map needs exactly one P");
+    static_assert(STOCK.ghosts[0] >= 0 && STOCK.ghosts[1] >= 0 && STOCK.ghosts[2] >= 0 && STOCK.ghosts[3] >= 0,
+        "the stock map is missing a ghost spawn");
+    static_assert(STOCK.foodCount > 0, "the stock map has no food");
+    static_assert(STOCK.unreachableFood == 0, "Pacman can't reach every pellet of the stock map");
+
+    Vector2i tileOf(int index) const {
+        return index < 0 ? Vector2i(-1, -1) : Vector2i(index % width, index / width);
+    }
+
+    void init() {
+        // Default offset position
+        offset = Vector2f(60.f, 40.f);
+        origin = FixedPos::fromPixels(offset);
+
+        // Fixed wall colour. No srand here: levels are built on a loader thread
+        // while the simulation thread relies on its own per-tick seed.
+        wallColor = Color(20, 80, 200); // Start with a nice blue color
+
+        // Initialize maze
+        reset();
+        buildWallMesh();
+
+        // Debug message to verify offset values
+        LOG_DEBUG(LOG_MAZE, "Maze initialized with offset: (%.0f, %.0f)", offset.x, offset.y);
+    }
+
+public:
+    // The stock map: its tables are copied from STOCK, nothing is parsed
+    Maze() {
+        layout.assign(STOCK.tiles, STOCK.tiles + WIDTH * HEIGHT);
+        neighbours.assign(STOCK.neighbours, STOCK.neighbours + WIDTH * HEIGHT);
+        wallPlanes.assign(STOCK.walls, STOCK.walls + HEIGHT);
+        foodPlanes.assign(STOCK.food, STOCK.food + HEIGHT);
+        pacmanStart = tileOf(STOCK.pacman);
+        for (int i = 0; i < 4; ++i) ghostStarts[i] = tileOf(STOCK.ghosts[i]);
+        layoutFood = STOCK.foodCount;
+        init();
+    }
+
+    // Any map in the same format ('#' wall, '.' pellet, 'o' energizer,
+    // 'P' Pacman, '0'-'3' ghosts); short rows are padded with spaces. The
+    // tables are built here with the functions STOCK was compiled with.
+    explicit Maze(const vector<string>& rows) {
+        height = static_cast<int>(rows.size());
+        width = 0;
+        for (const string& row : rows) {
+            width = std::max(width, static_cast<int>(row.length()));
+        }
+        int count = width * height;
+        layout.resize(count);
+        for (int row = 0; row < height; ++row) {
+            MazeTables::padRow(rows[row].c_str(), static_cast<int>(rows[row].length()), width, layout.data() + row * width);
+        }
+        neighbours.resize(count);
+        MazeTables::buildNeighbours(layout.data(), width, height, neighbours.data());
+        int planeRows = std::min(height, static_cast<int>(GameState::MAX_HEIGHT));
+        wallPlanes.resize(planeRows);
+        foodPlanes.resize(planeRows);
+        MazeTables::buildPlanes(layout.data(), width, planeRows, wallPlanes.data(), foodPlanes.data());
+        pacmanStart = tileOf(MazeTables::find(layout.data(), count, 'P'));
+        for (int i = 0; i < 4; ++i) ghostStarts[i] = tileOf(MazeTables::find(layout.data(), count, static_cast<char>('0' + i)));
+        layoutFood = MazeTables::countFood(layout.data(), count);
+        init();
+    }
+
+
+
+    // Super mode runs out on the ticks of this wheel (GameWorld's). A maze
+    // without one, as in the tools, stays in super mode until it is reset.
+    void setTimers(TimerWheel* wheel) {
+        setSuperMode(false);
+        timers = wheel;
+    }
+
+    void setSuperMode(bool mode) {
+        if (mode) {
+            startSuperMode(TimerWheel::ticksFor(superDuration));
+            LOG_INFO(LOG_MAZE, "Super mode activated for %.0f seconds!", superDuration);
+            return;
+        }
+        superMode = false;
+        if (timers) timers->cancel(superModeEnd);
+        superModeEnd = 0;
+    }
+
+    void startSuperMode(uint32_t ticks) {
+        setSuperMode(false);
+        superMode = true;
+        if (timers) {
+            superModeEnd = timers->schedule(ticks, [this](uint32_t) {
+                superMode = false;
+                superModeEnd = 0;
+                LOG_INFO(LOG_MAZE, "Super mode expired!");
+            });
+        }
+    }
+
+    bool isSuperModeActive() const {
+        return superMode;
+    }
+
+    float getSuperModeTimeRemaining() const {
+        if (!superMode) return 0.0f;
+        if (!timers) return superDuration;
+        return static_cast<float>(timers->remaining(superModeEnd)) / TimerWheel::TICK_RATE;
+    }
+
+    // Tile as it is in the original map data, before anything was eaten
+    char baseTile(int row, int col) const {
+        if (row < 0 || row >= height || col < 0 || col >= width) return ' ';
+        return layout[row * width + col];
+    }
+
+    // Whether the tile planes of a snapshot can hold this maze. A bigger one
+    // keeps its food in a PelletPlane as well.
+    bool fitsSnapshot() const {
+        return width <= GameState::MAX_WIDTH && height <= GameState::MAX_HEIGHT;
+    }
+
+    // Fill the maze part of a snapshot (tile planes, food, super mode time).
+    // The planes hold the first GameState::MAX_WIDTH x MAX_HEIGHT tiles; food
+    // gets the whole food of a maze bigger than that, and nothing otherwise.
+    void saveState(GameState& state, PelletPlane& food) const {
+        state.width = static_cast<uint16_t>(std::min(width, static_cast<int>(GameState::MAX_WIDTH)));
+        state.height = static_cast<uint16_t>(std::min(height, static_cast<int>(GameState::MAX_HEIGHT)));
+        state.mazeWidth = static_cast<uint16_t>(width);
+        state.mazeHeight = static_cast<uint16_t>(height);
+        for (int row = 0; row < state.height; ++row) {
+            uint32_t pellets = 0, energizers = 0;
+            const char* line = tiles.data() + row * width;
+            // Walls never change and food only goes where the layout had it
+            for (uint32_t bits = foodPlanes[row]; bits != 0; bits &= bits - 1) {
+                int col = std::countr_zero(bits);
+                if (line[col] == '.') pellets |= 1u << col;
+                else if (line[col] == 'o') energizers |= 1u << col;
+            }
+            state.walls[row] = wallPlanes[row];
+            state.pellets[row] = pellets;
+            state.energizers[row] = energizers;
+        }
+        state.totalFood = totalFood;
+        state.mazeSuperRemaining = getSuperModeTimeRemaining();
+        food = foodLeft;
+    }
+
+    // Whether a snapshot was taken of a maze this size
+    bool canLoad(const GameState& state, const PelletPlane& food) const {
+        if (state.mazeWidth != width || state.mazeHeight != height) return false;
+        return fitsSnapshot() || (food.getWidth() == width && food.getHeight() == height);
+    }
+
+    // Restore pellets and super mode from a snapshot that canLoad(). Only food
+    // tiles of the original map are touched, so spawn markers and walls stay
+    // as they are.
+    void loadState(const GameState& state, const PelletPlane& food) {
+        if (fitsSnapshot()) {
+            uint32_t inSnapshot = width < MazeTables::PLANE_BITS ? (1u << width) - 1 : 0xffffffffu;
+            for (int row = 0; row < height; ++row) {
+                char* line = tiles.data() + row * width;
+                for (uint32_t bits = foodPlanes[row] & inSnapshot; bits != 0; bits &= bits - 1) {
+                    int col = std::countr_zero(bits);
+                    if (state.hasPellet(row, col)) line[col] = '.';
+                    else if (state.hasEnergizer(row, col)) line[col] = 'o';
+                    else line[col] = ' ';
+                }
+            }
+        }
+        else {
+            // Only chunks the snapshot doesn't share with the live plane
+            // changed since it was taken
+            const int chunk = PelletPlane::CHUNK;
+            for (int top = 0; top < height; top += chunk) {
+                for (int left = 0; left < width; left += chunk) {
+                    if (foodLeft.sharesChunk(food, top, left)) continue;
+                    for (int row = top; row < std::min(top + chunk, height); ++row) {
+                        for (int col = left; col < std::min(left + chunk, width); ++col) {
+                            char tile = layout[row * width + col];
+                            if (MazeTables::isFood(tile)) tiles[row * width + col] = food.test(row, col) ? tile : ' ';
+                        }
+                    }
+                }
+            }
+            foodLeft = food;
+        }
+        totalFood = state.totalFood;
+
+        setSuperMode(false);
+        if (state.mazeSuperRemaining > 0.f) startSuperMode(TimerWheel::ticksFor(state.mazeSuperRemaining));
+    }
+
+    // Back to the layout as loaded. The grid is already padded and its food
+    // counted, so this is one copy.
+    void reset() {
+        setSuperMode(false);
+        tiles.resize(layout.size());
+        if (!layout.empty()) std::memcpy(tiles.data(), layout.data(), layout.size());
+        totalFood = layoutFood;
+        if (fitsSnapshot()) {
+            foodLeft = PelletPlane();
+            return;
+        }
+        foodLeft = PelletPlane(width, height);
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                if (MazeTables::isFood(layout[row * width + col])) foodLeft.set(row, col, true);
+            }
+        }
+    }
+    // Walls never change during a round, so their rectangles are worked out once
+    // per layout instead of every frame
+    void buildWallMesh() {
+        // Small rendering adjustment for visual consistency
+        const float renderAdjustX = -7.0f;
+        const float renderAdjustY = 10.0f;
+        const int half = CELL_SIZE / 2;
+        const int wall = WALL_THICKNESS;
+        const int halfWall = WALL_THICKNESS / 2;
+
+        wallRects.clear();
+        wallCols.clear();
+        wallRowStart.assign(1, 0);
+
+        // Improved maze rendering approach with node-based walls
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                if (tiles[row * width + col] != '#') continue;
+                float x = offset.x + col * CELL_SIZE + renderAdjustX;
+                float y = offset.y + row * CELL_SIZE + renderAdjustY;
+
+                // Wall connections in all four directions
+                uint8_t links = neighbours[row * width + col];
+                bool wallAbove = (links & MazeTables::UP_BIT) != 0;
+                bool wallBelow = (links & MazeTables::DOWN_BIT) != 0;
+                bool wallLeft = (links & MazeTables::LEFT_BIT) != 0;
+                bool wallRight = (links & MazeTables::RIGHT_BIT) != 0;
+
+                // A wall node
+                wallRects.push_back(FloatRect(x + 10 + half - halfWall, y + 10 + half - halfWall, wall, wall));
+
+                // Wall connections
+                if (wallAbove) {
+                    wallRects.push_back(FloatRect(x + 10 + half - halfWall, y + 10, wall, half + halfWall));
+                }
+
+                if (wallBelow) {
+                    wallRects.push_back(FloatRect(x + 10 + half - halfWall, y + 10 + half, wall, half + halfWall));
+                }
+
+                if (wallLeft) {
+                    wallRects.push_back(FloatRect(x + 10, y + 10 + half - halfWall, half + halfWall, wall));
+                }
+
+                if (wallRight) {
+                    wallRects.push_back(FloatRect(x + 10 + half, y + 10 + half - halfWall, half + halfWall, wall));
+                }
+                wallCols.resize(wallRects.size(), col);
+            }
+            wallRowStart.push_back(static_cast<int>(wallRects.size()));
+        }
+    }
+
+    // Exchange everything with another maze. All the bulk is in vectors, so this
+    // is a handful of pointer swaps: how a preloaded level is switched in.
+    // Super mode ends on both, and each keeps its own timer wheel.
+    void swap(Maze& other) {
+        setSuperMode(false);
+        other.setSuperMode(false);
+        std::swap(offset, other.offset);
+        std::swap(origin, other.origin);
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        layout.swap(other.layout);
+        tiles.swap(other.tiles);
+        neighbours.swap(other.neighbours);
+        wallPlanes.swap(other.wallPlanes);
+        foodPlanes.swap(other.foodPlanes);
+        std::swap(foodLeft, other.foodLeft);
+        std::swap(pacmanStart, other.pacmanStart);
+        std::swap(ghostStarts, other.ghostStarts);
+        std::swap(layoutFood, other.layoutFood);
+        std::swap(wallColor, other.wallColor);
+        std::swap(totalFood, other.totalFood);
+        wallRects.swap(other.wallRects);
+        wallCols.swap(other.wallCols);
+        wallRowStart.swap(other.wallRowStart);
+    }
+
+    // The board with the margins around it, the area a camera may show
+    FloatRect getBounds() const {
+        return FloatRect(0.f, 0.f, offset.x * 2 + width * CELL_SIZE, offset.y * 2 + height * CELL_SIZE);
+    }
+
+    // Submit walls, pellets and the super mode timer bar to the frame's render queue
+    void draw(RenderQueue& queue) {
+        draw(queue, getBounds(), nullptr);
+    }
+
+    // Same, for the tiles that intersect visible only (see camera.h). Only the
+    // visible rows and columns are visited, so the cost doesn't grow with the maze.
+    void draw(RenderQueue& queue, const FloatRect& visible, CullStats* stats)
+    {
+        // Handle super mode color with smooth transition effect
+        Color drawColor;
+        if (isSuperModeActive()) {
+            drawColor = Color::Yellow;
+
+            // Flash effect when super mode is about to expire (last 3 seconds)
+            float remainingTime = getSuperModeTimeRemaining();
+            if (remainingTime < 3.0f) {
+                // Flash between blue and normal color
+                if (static_cast<int>(remainingTime * 10) % 2 == 0) {
+                    drawColor = Color::Blue;
+                }
+                else {
+                    drawColor = Color::Yellow;
+                }
+            }
+        }
+        else {
+            drawColor = Color::Blue;
+        }
+
+        // Draw timer if in super mode
+        if (isSuperModeActive()) {
+            float remainingTime = getSuperModeTimeRemaining();
+            // Create timer bar at the top of the screen
+            queue.submitRect(FloatRect(offset.x, offset.y - 20, width * CELL_SIZE * (remainingTime / superDuration), 10),
+                Color::Yellow, LAYER_OVERLAY);
+        }
+
+        // Tiles draw up to a tile right or below their cell (render adjustment,
+        // connections), so the range gets one extra tile on each side
+        int firstCol = std::max(0, static_cast<int>(std::floor((visible.left - offset.x) / CELL_SIZE)) - 1);
+        int lastCol = std::min(width - 1, static_cast<int>(std::floor((visible.left + visible.width - offset.x) / CELL_SIZE)) + 1);
+        int firstRow = std::max(0, static_cast<int>(std::floor((visible.top - offset.y) / CELL_SIZE)) - 1);
+        int lastRow = std::min(height - 1, static_cast<int>(std::floor((visible.top + visible.height - offset.y) / CELL_SIZE)) + 1);
+
+        if (stats) {
+            int visited = (lastCol >= firstCol && lastRow >= firstRow) ? (lastCol - firstCol + 1) * (lastRow - firstRow + 1) : 0;
+            stats->tilesDrawn += visited;
+            stats->tilesCulled += width * height - visited;
+        }
+        if (lastCol < firstCol || lastRow < firstRow) return;
+
+        for (int row = firstRow; row <= lastRow; ++row) {
+            const int* cols = wallCols.data();
+            int end = wallRowStart[row + 1];
+            int i = static_cast<int>(std::lower_bound(cols + wallRowStart[row], cols + end, firstCol) - cols);
+            for (; i < end && cols[i] <= lastCol; ++i) {
+                queue.submitRect(wallRects[i], drawColor, LAYER_MAZE);
+            }
+        }
+
+        // Small rendering adjustment for visual consistency
+        const float renderAdjustX = -7.0f;
+        const float renderAdjustY = 10.0f;
+        const int half = CELL_SIZE / 2;
+
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int col = firstCol; col <= lastCol; ++col) {
+                char tile = tiles[row * width + col];
+                if (tile != '.' && tile != 'o') continue;
+                float x = offset.x + col * CELL_SIZE + renderAdjustX;
+                float y = offset.y + row * CELL_SIZE + renderAdjustY;
+
+                if (tile == '.') {
+                    // Center the dot in the cell
+                    queue.submitDisc(Vector2f(x + 14 + half, y + 10 + half), CELL_SIZE / 10, Color::White, LAYER_PELLETS);
+                }
+                else {
+                    // Center the energizer in the cell
+                    queue.submitDisc(Vector2f(x + 14 + half, y + 10 + half), CELL_SIZE / 5, Color::Yellow, LAYER_PELLETS);
+                }
+            }
+        }
+    }
+
+
+
+    bool foodremains() const { return totalFood > 0; }
+
+    char getTile(int row, int col) const {
+        if (row >= 0 && row < height && col >= 0 && col < width)
+            return tiles[row * width + col];
+        return ' ';
+    }
+
+    // Position queries work in fixed point (fixedpoint.h). The Vector2f
+    // versions round to the nearest 1/256 px first and give the same answers.
+
+    // Check if a cell is a wall (same as before)
+    bool isWall(FixedPos pos) const {
+        Vector2i cell = getCell(pos);
+        return getTile(cell.y, cell.x) == '#';
+    }
+    bool isWall(Vector2f pos) const { return isWall(FixedPos::fromPixels(pos)); }
+
+    // Check if position is within a pixel of a vertical or horizontal grid line
+    bool isAlignedWithGrid(FixedPos position) const {
+        int32_t inCellX = floorMod(position.x - origin.x, CELL_UNITS);
+        int32_t inCellY = floorMod(position.y - origin.y, CELL_UNITS);
+
+        return (inCellX < FixedPos::ONE || inCellX > CELL_UNITS - FixedPos::ONE ||
+            inCellY < FixedPos::ONE || inCellY > CELL_UNITS - FixedPos::ONE);
+    }
+    bool isAlignedWithGrid(Vector2f position) const { return isAlignedWithGrid(FixedPos::fromPixels(position)); }
+
+    // Return the nearest grid line intersection point
+    Vector2f getNearestGridIntersection(Vector2f position) {
+        int xLine = static_cast<int>((position.x - offset.x) / CELL_SIZE);
+        int yLine = static_cast<int>((position.y - offset.y) / CELL_SIZE);
+
+        float nearestX = offset.x + xLine * CELL_SIZE;
+        float nearestY = offset.y + yLine * CELL_SIZE;
+
+        return Vector2f(nearestX, nearestY);
+    }
+
+    // Check if movement is valid along the line-based grid
+    bool canMove(Vector2f currentPos, Vector2f direction) const {
+        Vector2f targetPos = currentPos + direction;
+
+        Vector2i currentCell = getCell(currentPos);
+        Vector2i targetCell = getCell(targetPos);
+
+        // Disallow movement outside grid
+        if (targetCell.x < 0 || targetCell.x >= width ||
+            targetCell.y < 0 || targetCell.y >= height) {
+            return false;
+        }
+
+        // For horizontal or vertical movement only
+        if (direction.x != 0 && direction.y != 0) {
+            return false; // Disallow diagonal movement
+        }
+
+        // Check for wall in target direction
+        if (getTile(targetCell.y, targetCell.x) == '#') {
+            return false;
+        }
+
+        return true;
+    }
+
+    // Checks if a position lies along a valid walkable line
+    bool isWalkable(FixedPos position) const {
+        Vector2i cell = getCell(position);
+        if (cell.y < 0 || cell.y >= height || cell.x < 0 || cell.x >= width)
+            return false;
+
+        return tiles[cell.y * width + cell.x] != '#';
+    }
+    bool isWalkable(Vector2f position) const { return isWalkable(FixedPos::fromPixels(position)); }
+
+    // Pacman eats a pellet within 0.4 tiles of its centre
+    static const int32_t EATING_REACH = CELL_UNITS * 2 / 5;
+
+    bool isWithinEatingDistance(FixedPos pos, Vector2i cell) const {
+        int64_t dx = pos.x - (origin.x + cell.x * CELL_UNITS + CELL_UNITS / 2);
+        int64_t dy = pos.y - (origin.y + cell.y * CELL_UNITS + CELL_UNITS / 2);
+        int64_t reach = EATING_REACH;
+        return dx * dx + dy * dy < reach * reach;
+    }
+
+    // Movement is swept: what a step passes on its way from one position to
+    // the next is found in the order it is reached, as a fraction of the step
+    // from 0 to SWEEP_END. A jump (the side tunnel, a teleport) is no step;
+    // whoever made it knows, and sweeps only where it landed (from == to).
+    static const int32_t SWEEP_END = 1 << 16;
+
+    // Append the food tiles the step from `from` to `to` passes within
+    // eating distance of to hits, in the order they are reached. Only the
+    // tiles around the step are looked at, however fast it is.
+    void sweepFood(FixedPos from, FixedPos to, vector<FoodHit>& hits) const {
+        int firstCol = std::max(0, getCol(FixedPos(std::min(from.x, to.x) - EATING_REACH, 0)));
+        int lastCol = std::min(width - 1, getCol(FixedPos(std::max(from.x, to.x) + EATING_REACH, 0)));
+        int firstRow = std::max(0, getRows(FixedPos(0, std::min(from.y, to.y) - EATING_REACH)));
+        int lastRow = std::min(height - 1, getRows(FixedPos(0, std::max(from.y, to.y) + EATING_REACH)));
+
+        int64_t dx = to.x - from.x;
+        int64_t dy = to.y - from.y;
+        int64_t length2 = dx * dx + dy * dy;
+        int64_t reach = EATING_REACH;
+        size_t first = hits.size();
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int col = firstCol; col <= lastCol; ++col) {
+                char tile = tiles[row * width + col];
+                if (tile != '.' && tile != 'o') continue;
+
+                // The point of the step closest to the tile's centre
+                int64_t cx = origin.x + col * CELL_UNITS + CELL_UNITS / 2 - from.x;
+                int64_t cy = origin.y + row * CELL_UNITS + CELL_UNITS / 2 - from.y;
+                int64_t at = length2 > 0 ? std::max<int64_t>(0, std::min<int64_t>(SWEEP_END, (cx * dx + cy * dy) * SWEEP_END / length2)) : 0;
+                int64_t ex = cx - dx * at / SWEEP_END;
+                int64_t ey = cy - dy * at / SWEEP_END;
+                if (ex * ex + ey * ey < reach * reach) {
+                    hits.push_back({ Vector2i(col, row), static_cast<int32_t>(at) });
+                }
+            }
+        }
+        std::sort(hits.begin() + first, hits.end(), [](const FoodHit& a, const FoodHit& b) {
+            if (a.at != b.at) return a.at < b.at;
+            return a.tile.y != b.tile.y ? a.tile.y < b.tile.y : a.tile.x < b.tile.x;
+        });
+    }
+
+    // Eat whatever is on a tile: '.' a pellet, 'o' an energizer (which starts
+    // super mode), ' ' nothing
+    char eat(Vector2i cell) {
+        char food = getTile(cell.y, cell.x);
+        if (food != '.' && food != 'o') return ' ';
+        tiles[cell.y * width + cell.x] = ' ';
+        if (!fitsSnapshot()) foodLeft.set(cell.y, cell.x, false);
+        totalFood--;
+        if (food == 'o') setSuperMode(true);
+        return food;
+    }
+
+    bool isFood(Vector2f position) {
+        FixedPos pos = FixedPos::fromPixels(position);
+        Vector2i cell = getCell(pos);
+
+        // Check if the cell contains food
+        return getTile(cell.y, cell.x) == '.' && isWithinEatingDistance(pos, cell) && eat(cell) == '.';
+    }
+
+    bool isSuperFood(Vector2f position) {
+        FixedPos pos = FixedPos::fromPixels(position);
+        Vector2i cell = getCell(pos);
+
+        // Check if the cell contains super food
+        return getTile(cell.y, cell.x) == 'o' && isWithinEatingDistance(pos, cell) && eat(cell) == 'o';
+    }
+
+    // Improved collision detection between entities
+    bool checkCollision(Vector2f pos1, Vector2f pos2, float threshold = 0.5f) {
+        float distance = sqrt(pow(pos1.x - pos2.x, 2) + pow(pos1.y - pos2.y, 2));
+        return distance < CELL_SIZE * threshold;
+    }
+
+    int getFoodCount() const { return totalFood; }
+
+    Vector2f getOffset() const { return offset; }
+
+    // Improved entity-to-maze position alignment
+    Vector2f alignToGrid(Vector2f pos) {
+        Vector2i cell = getCell(pos);
+        return Vector2f(
+            offset.x + cell.x * CELL_SIZE + CELL_SIZE / 2.0f,
+            offset.y + cell.y * CELL_SIZE + CELL_SIZE / 2.0f
+        );
+    }
+    // Get the center of the current cell
+    Vector2f getCellCenter(Vector2f position) {
+        Vector2i cell = getCell(position);
+        return Vector2f(
+            offset.x + cell.x * CELL_SIZE + CELL_SIZE / 2.0f,
+            offset.y + cell.y * CELL_SIZE + CELL_SIZE / 2.0f
+        );
+    }
+    // Convert grid cell coordinates to world position
+    Vector2f cellToPosition(int col, int row) {
+        return Vector2f(
+            offset.x + col * CELL_SIZE + CELL_SIZE / 2.0f,
+            offset.y + row * CELL_SIZE + CELL_SIZE / 2.0f
+        );
+    }
+
+    // Convert world position to perfect grid cell coordinates
+    Vector2i getCell(FixedPos pos) const {
+        int col = getCol(pos);
+        int row = getRows(pos);
+
+        // Ensure values are within bounds
+        col = std::max(0, std::min(col, width - 1));
+        row = std::max(0, std::min(row, height - 1));
+
+        return { col, row };
+    }
+    Vector2i getCell(Vector2f pos) const { return getCell(FixedPos::fromPixels(pos)); }
+    int getCol(FixedPos pos) const {
+        return floorDiv(pos.x - origin.x, CELL_UNITS);
+    }
+    int getCol(Vector2f pos) const { return getCol(FixedPos::fromPixels(pos)); }
+    int getRows(FixedPos pos) const {
+        return floorDiv(pos.y - origin.y, CELL_UNITS);
+    }
+    int getRows(Vector2f pos) const { return getRows(FixedPos::fromPixels(pos)); }
+    static int getCellSize() { return CELL_SIZE; }
+    static int32_t getCellUnits() { return CELL_UNITS; }
+    FixedPos getOrigin() const { return origin; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Spawns were found when the layout was loaded (compiled, for the stock map)
+    Vector2i getP() const { return pacmanStart; }
+
+    Vector2i getGhost(char ghostId) const {
+        if (ghostId >= '0' && ghostId <= '3') return ghostStarts[ghostId - '0'];
+        return tileOf(MazeTables::find(tiles.data(), static_cast<int>(tiles.size()), ghostId));
+    }
+
+    Vector2i getGhost0() const { return getGhost('0'); }
+    Vector2i getGhost1() const { return getGhost('1'); }
+    Vector2i getGhost2() const { return getGhost('2'); }
+    Vector2i getGhost3() const { return getGhost('3'); }
 };
\ No newline at end of file
@@ -0,0 +1,404 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mazegen.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Chunked, memory-mapped storage for huge mazes.
+//
+// A Maze keeps its rows as strings and builds everything up front, which is
+// right for the campaign levels but not for a board of millions of tiles. A
+// chunk file (.mzc, written by ChunkedMazeFile::write or mazegen --chunks)
+// cuts the board into CHUNK_SIZE x CHUNK_SIZE chunks. Each chunk is one fixed
+// size record: the tiles as a byte each, a bit per tile for pellets eaten and a
+// little bookkeeping, padded to whole pages.
+//
+// ChunkedMazeStore maps the file and reads nothing but the header on open, so
+// opening costs the same for any size. Its user tells it every frame what it
+// needs: a camera's tile rectangle (retainArea) and the tiles the entities are
+// on (retainAround). Chunks come in when first needed and go out after
+// EVICT_AFTER updates without being needed; a chunk with pellets eaten is
+// flushed to the file first and then dropped from the working set. What the
+// process keeps resident follows the window and the entities, not the maze.
+//
+// The game doesn't play from a store yet. Maze, the camera and the entities
+// work on a Maze built from rows, so the one user today is mazegen --walk,
+// which sweeps a window-sized view across a chunk file. Playing a .mzc level
+// needs Maze's tile and food queries backed by a store, with retainArea fed
+// from Camera::cullRect and retainAround from Pacman and the ghosts.
+//
+// Eaten pellets live in the file. Each round has a generation number; a chunk
+// whose record is from an older generation has its eaten bits cleared when it
+// comes in, so starting a round doesn't touch every chunk either.
+
+static const uint32_t MAZE_CHUNK_MAGIC = 0x435A4D50;   // "PMZC"
+static const uint32_t MAZE_CHUNK_VERSION = 1;
+
+struct MazeChunkHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;           // tiles
+    int32_t height;
+    int32_t chunkSize;       // ChunkedMazeFile::CHUNK_SIZE of the writer
+    int32_t chunksX;
+    int32_t chunksY;
+    uint32_t generation;     // round the eaten bits belong to
+    int64_t totalFood;       // pellets and energizers in the layout
+    int64_t foodLeft;        // in the current generation
+};
+
+class ChunkedMazeFile {
+public:
+    static const int CHUNK_SIZE = 64;
+    static const int CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;
+    static const size_t PAGE = 4096;                 // records and the header are page aligned
+    static const size_t HEADER_SIZE = PAGE;
+
+    struct Record {
+        uint32_t generation;                   // eaten is valid for this round
+        int32_t food;                          // pellets and energizers in tiles
+        int32_t foodLeft;
+        uint32_t reserved;
+        uint8_t tiles[CHUNK_TILES];            // map characters, ' ' past the maze edge
+        uint8_t eaten[CHUNK_TILES / 8];
+    };
+
+    static const size_t RECORD_SIZE = (sizeof(Record) + PAGE - 1) / PAGE * PAGE;
+
+    static size_t fileSize(int chunksX, int chunksY) {
+        return HEADER_SIZE + static_cast<size_t>(chunksX) * chunksY * RECORD_SIZE;
+    }
+
+    // Write rows (the Maze format) as a chunk file, one chunk at a time
+    static bool write(const std::vector<std::string>& rows, const std::string& path) {
+        MazeChunkHeader header = {};
+        header.magic = MAZE_CHUNK_MAGIC;
+        header.version = MAZE_CHUNK_VERSION;
+        header.width = MazeLayout::width(rows);
+        header.height = static_cast<int32_t>(rows.size());
+        header.chunkSize = CHUNK_SIZE;
+        header.chunksX = (header.width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        header.chunksY = (header.height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        header.generation = 1;
+        if (header.width == 0 || header.height == 0) return false;
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+
+        std::vector<uint8_t> page(HEADER_SIZE, 0);
+        std::vector<uint8_t> recordBytes(RECORD_SIZE, 0);
+        bool ok = std::fwrite(page.data(), 1, page.size(), file) == page.size();
+
+        for (int cy = 0; cy < header.chunksY && ok; ++cy) {
+            for (int cx = 0; cx < header.chunksX && ok; ++cx) {
+                std::fill(recordBytes.begin(), recordBytes.end(), 0);
+                Record* record = reinterpret_cast<Record*>(recordBytes.data());
+                record->generation = header.generation;
+                for (int y = 0; y < CHUNK_SIZE; ++y) {
+                    int row = cy * CHUNK_SIZE + y;
+                    for (int x = 0; x < CHUNK_SIZE; ++x) {
+                        int col = cx * CHUNK_SIZE + x;
+                        char c = row < header.height ? MazeLayout::tile(rows, row, col) : ' ';
+                        record->tiles[y * CHUNK_SIZE + x] = static_cast<uint8_t>(c);
+                        record->food += MazeLayout::isFood(c);
+                    }
+                }
+                record->foodLeft = record->food;
+                header.totalFood += record->food;
+                ok = std::fwrite(recordBytes.data(), 1, recordBytes.size(), file) == recordBytes.size();
+            }
+        }
+
+        // Header last, once the food is counted
+        header.foodLeft = header.totalFood;
+        std::memcpy(page.data(), &header, sizeof(header));
+        ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(page.data(), 1, page.size(), file) == page.size();
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+};
+
+class ChunkedMazeStore {
+public:
+    typedef ChunkedMazeFile::Record Record;
+    static const int CHUNK_SIZE = ChunkedMazeFile::CHUNK_SIZE;
+    static const int EVICT_AFTER = 120;      // updates a chunk may go unneeded before it is dropped
+
+    struct Stats {
+        size_t resident = 0;                 // chunks in the working set now
+        size_t peakResident = 0;
+        uint64_t pagedIn = 0;
+        uint64_t evicted = 0;
+        uint64_t writtenBack = 0;            // evicted or closed with pellets eaten
+    };
+
+private:
+    struct Resident {
+        Record* record;
+        uint64_t lastNeeded;
+        bool dirty;
+    };
+
+    uint8_t* base = nullptr;
+    size_t size = 0;
+    MazeChunkHeader* header = nullptr;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    std::unordered_map<uint32_t, Resident> resident;
+    uint32_t cachedIndex = UINT32_MAX;       // last chunk looked up, most lookups hit it
+    Resident* cached = nullptr;
+    uint64_t updates = 0;
+    Stats stats;
+
+    Record* recordAt(uint32_t index) const {
+        return reinterpret_cast<Record*>(base + ChunkedMazeFile::HEADER_SIZE + index * ChunkedMazeFile::RECORD_SIZE);
+    }
+
+    // Writes pages of a record back to the file
+    void flush(Record* record) {
+#ifdef _WIN32
+        FlushViewOfFile(record, ChunkedMazeFile::RECORD_SIZE);
+#else
+        msync(record, ChunkedMazeFile::RECORD_SIZE, MS_ASYNC);
+#endif
+    }
+
+    Resident& pageIn(uint32_t index) {
+        if (index == cachedIndex) {
+            cached->lastNeeded = updates;
+            return *cached;
+        }
+        std::unordered_map<uint32_t, Resident>::iterator it = resident.find(index);
+        if (it == resident.end()) {
+            Record* record = recordAt(index);
+#ifndef _WIN32
+            madvise(record, ChunkedMazeFile::RECORD_SIZE, MADV_WILLNEED);
+#endif
+            Resident entry = { record, updates, false };
+            if (record->generation != header->generation) {
+                // Left over from an earlier round: every pellet is back
+                std::memset(record->eaten, 0, sizeof(record->eaten));
+                record->foodLeft = record->food;
+                record->generation = header->generation;
+                entry.dirty = true;
+            }
+            it = resident.emplace(index, entry).first;
+            stats.pagedIn++;
+            stats.resident = resident.size();
+            if (stats.resident > stats.peakResident) stats.peakResident = stats.resident;
+        }
+        it->second.lastNeeded = updates;
+        cachedIndex = index;
+        cached = &it->second;
+        return it->second;
+    }
+
+    void evict(Resident& entry) {
+        if (entry.dirty) {
+            flush(entry.record);
+            stats.writtenBack++;
+        }
+        // The pages stay in the file (and the OS cache); they just leave this process
+#ifdef _WIN32
+        VirtualUnlock(entry.record, ChunkedMazeFile::RECORD_SIZE);
+#else
+        madvise(entry.record, ChunkedMazeFile::RECORD_SIZE, MADV_DONTNEED);
+#endif
+        stats.evicted++;
+    }
+
+    // Chunk of a tile, false outside the maze
+    bool locate(int row, int col, uint32_t& index, int& offset) const {
+        if (!header || row < 0 || col < 0 || row >= header->height || col >= header->width) return false;
+        index = static_cast<uint32_t>((row / CHUNK_SIZE) * header->chunksX + col / CHUNK_SIZE);
+        offset = (row % CHUNK_SIZE) * CHUNK_SIZE + col % CHUNK_SIZE;
+        return true;
+    }
+
+public:
+    ChunkedMazeStore() = default;
+    ChunkedMazeStore(const ChunkedMazeStore&) = delete;
+    ChunkedMazeStore& operator=(const ChunkedMazeStore&) = delete;
+    ~ChunkedMazeStore() { close(); }
+
+    // Map a chunk file. Only the header is read.
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(ChunkedMazeFile::HEADER_SIZE)) {
+            close();
+            return false;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0) : nullptr;
+        if (!view) {
+            close();
+            return false;
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(ChunkedMazeFile::HEADER_SIZE)) {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(info.st_size);
+        void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+#endif
+        base = static_cast<uint8_t*>(view);
+        header = reinterpret_cast<MazeChunkHeader*>(base);
+        if (header->magic != MAZE_CHUNK_MAGIC || header->version != MAZE_CHUNK_VERSION ||
+            header->chunkSize != CHUNK_SIZE || header->width <= 0 || header->height <= 0 ||
+            header->chunksX != (header->width + CHUNK_SIZE - 1) / CHUNK_SIZE ||
+            header->chunksY != (header->height + CHUNK_SIZE - 1) / CHUNK_SIZE ||
+            size < ChunkedMazeFile::fileSize(header->chunksX, header->chunksY)) {
+            close();
+            return false;
+        }
+        stats = Stats();
+        return true;
+    }
+
+    // Write back every chunk with pellets eaten and unmap
+    void close() {
+        for (std::unordered_map<uint32_t, Resident>::iterator it = resident.begin(); it != resident.end(); ++it) {
+            if (it->second.dirty) {
+                flush(it->second.record);
+                stats.writtenBack++;
+            }
+        }
+        resident.clear();
+        cachedIndex = UINT32_MAX;
+        cached = nullptr;
+        stats.resident = 0;
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap(base, size);
+#endif
+        base = nullptr;
+        header = nullptr;
+        size = 0;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    int getWidth() const { return header ? header->width : 0; }
+    int getHeight() const { return header ? header->height : 0; }
+    int64_t getTotalFood() const { return header ? header->totalFood : 0; }
+    int64_t getFoodLeft() const { return header ? header->foodLeft : 0; }
+    bool foodremains() const { return getFoodLeft() > 0; }
+    const Stats& getStats() const { return stats; }
+
+    // Start a round with every pellet back. Chunks catch up when they come in.
+    void beginRound() {
+        if (!header) return;
+        header->generation++;
+        header->foodLeft = header->totalFood;
+        for (std::unordered_map<uint32_t, Resident>::iterator it = resident.begin(); it != resident.end(); ++it) {
+            Record* record = it->second.record;
+            std::memset(record->eaten, 0, sizeof(record->eaten));
+            record->foodLeft = record->food;
+            record->generation = header->generation;
+            it->second.dirty = true;
+        }
+    }
+
+    // Tile as Maze::getTile has it: eaten pellets are ' ', outside the maze is ' '
+    char getTile(int row, int col) {
+        uint32_t index;
+        int offset;
+        if (!locate(row, col, index, offset)) return ' ';
+        const Record* record = pageIn(index).record;
+        char c = static_cast<char>(record->tiles[offset]);
+        if (MazeLayout::isFood(c) && (record->eaten[offset >> 3] & (1u << (offset & 7)))) return ' ';
+        return c;
+    }
+
+    // Eat the pellet or energizer on a tile; false if there is none
+    bool eat(int row, int col) {
+        uint32_t index;
+        int offset;
+        if (!locate(row, col, index, offset)) return false;
+        Resident& entry = pageIn(index);
+        Record* record = entry.record;
+        uint8_t bit = static_cast<uint8_t>(1u << (offset & 7));
+        if (!MazeLayout::isFood(static_cast<char>(record->tiles[offset])) || (record->eaten[offset >> 3] & bit)) return false;
+        record->eaten[offset >> 3] |= bit;
+        record->foodLeft--;
+        header->foodLeft--;
+        entry.dirty = true;
+        return true;
+    }
+
+    // Keep the chunks under a tile rectangle (inclusive, clamped to the maze)
+    // resident, e.g. the camera's cull rectangle
+    void retainArea(int firstRow, int firstCol, int lastRow, int lastCol) {
+        if (!header) return;
+        int firstCy = std::max(0, firstRow) / CHUNK_SIZE;
+        int lastCy = std::min(header->height - 1, lastRow) / CHUNK_SIZE;
+        int firstCx = std::max(0, firstCol) / CHUNK_SIZE;
+        int lastCx = std::min(header->width - 1, lastCol) / CHUNK_SIZE;
+        for (int cy = firstCy; cy <= lastCy; ++cy) {
+            for (int cx = firstCx; cx <= lastCx; ++cx) {
+                pageIn(static_cast<uint32_t>(cy * header->chunksX + cx));
+            }
+        }
+    }
+
+    // Keep an entity's chunk and its neighbours resident, so it never waits on
+    // a page fault when it crosses into the next one
+    void retainAround(int row, int col) {
+        retainArea(row - CHUNK_SIZE, col - CHUNK_SIZE, row + CHUNK_SIZE, col + CHUNK_SIZE);
+    }
+
+    // Once per frame after the retain calls: drop chunks nothing needed lately
+    void update() {
+        updates++;
+        for (std::unordered_map<uint32_t, Resident>::iterator it = resident.begin(); it != resident.end();) {
+            if (updates - it->second.lastNeeded > static_cast<uint64_t>(EVICT_AFTER)) {
+                evict(it->second);
+                if (it->first == cachedIndex) {
+                    cachedIndex = UINT32_MAX;
+                    cached = nullptr;
+                }
+                it = resident.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        stats.resident = resident.size();
+    }
+};
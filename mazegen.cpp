@@ -0,0 +1,134 @@
+// Writes procedurally generated mazes (see mazegen.h) and checks them.
+//
+//     g++ -O2 -std=c++20 mazegen.cpp -o mazegen
+//     ./mazegen [--width N] [--height N] [--seed N] [--count N] [--out FILE] [--print]
+//               [--chunks FILE] [--walk FILE]
+//
+// Default is one 23x21 maze with seed 1. Per maze it reports the generation
+// time, pellet count, unreachable pellets, dead ends and whether the walls are
+// mirrored, and exits 1 if any maze fails a check. --out writes the last maze in the map
+// format the game reads (level4.txt, say); --count N generates N mazes with
+// consecutive seeds, for soak runs.
+//
+// --chunks writes the last maze as a chunk file (mazechunks.h). --walk opens a
+// chunk file instead of generating anything and sweeps a window-sized camera
+// diagonally across it, eating the pellets in its middle row, to show that
+// opening and the chunks kept resident don't grow with the maze.
+#include "mazechunks.h"
+#include "mazegen.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Camera sweep over a chunk file; see the header comment
+static int walkChunks(const std::string& path) {
+    const int viewCols = 24 + 4, viewRows = 27 + 4;   // 960x1050 window in 40 px tiles, plus the cull margin
+    auto start = std::chrono::steady_clock::now();
+    ChunkedMazeStore store;
+    if (!store.open(path)) {
+        std::fprintf(stderr, "Could not open %s as a chunk file\n", path.c_str());
+        return 1;
+    }
+    double openMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    store.beginRound();
+
+    int width = store.getWidth(), height = store.getHeight();
+    int steps = std::max(width, height);
+    int64_t eaten = 0;
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        int top = static_cast<int>(static_cast<int64_t>(step) * std::max(0, height - viewRows) / steps);
+        int left = static_cast<int>(static_cast<int64_t>(step) * std::max(0, width - viewCols) / steps);
+        store.retainArea(top, left, top + viewRows - 1, left + viewCols - 1);
+        store.retainAround(top + viewRows / 2, left + viewCols / 2);
+        for (int col = left; col < left + viewCols; ++col) {
+            eaten += store.eat(top + viewRows / 2, col);
+        }
+        store.update();
+    }
+    double walkMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const ChunkedMazeStore::Stats& stats = store.getStats();
+    std::printf("%s: %dx%d, %lld food, opened in %.3f ms\n", path.c_str(), width, height,
+        static_cast<long long>(store.getTotalFood()), openMillis);
+    std::printf("walk: %d frames in %.2f ms, %lld eaten, %lld left\n", steps, walkMillis,
+        static_cast<long long>(eaten), static_cast<long long>(store.getFoodLeft()));
+    std::printf("chunks: %llu paged in, %llu evicted, %llu written back, peak %zu resident (%zu KB)\n",
+        static_cast<unsigned long long>(stats.pagedIn), static_cast<unsigned long long>(stats.evicted),
+        static_cast<unsigned long long>(stats.writtenBack), stats.peakResident,
+        stats.peakResident * ChunkedMazeFile::RECORD_SIZE / 1024);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int width = 23, height = 21, count = 1;
+    uint32_t seed = 1;
+    std::string outPath, chunksPath, walkPath;
+    bool print = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--width" && hasValue) width = std::atoi(argv[++i]);
+        else if (arg == "--height" && hasValue) height = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--count" && hasValue) count = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else if (arg == "--chunks" && hasValue) chunksPath = argv[++i];
+        else if (arg == "--walk" && hasValue) walkPath = argv[++i];
+        else if (arg == "--print") print = true;
+        else {
+            std::fprintf(stderr, "usage: mazegen [--width N] [--height N] [--seed N] [--count N] [--out FILE] [--print] [--chunks FILE] [--walk FILE]\n");
+            return 2;
+        }
+    }
+
+    if (!walkPath.empty()) return walkChunks(walkPath);
+
+    bool failed = false;
+    std::vector<std::string> rows;
+    for (int i = 0; i < count; ++i) {
+        uint32_t mazeSeed = seed + static_cast<uint32_t>(i);
+        auto start = std::chrono::steady_clock::now();
+        rows = MazeGenerator::generate(width, height, mazeSeed);
+        double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        int food = 0;
+        for (const std::string& row : rows) {
+            for (char c : row) food += MazeLayout::isFood(c);
+        }
+        int unreachable = MazeLayout::unreachableFood(rows);
+        int deadEnds = MazeLayout::deadEnds(rows);
+        bool mirrored = MazeLayout::isMirrored(rows);
+        bool ok = unreachable == 0 && deadEnds == 0 && mirrored && food > 0;
+        failed = failed || !ok;
+
+        std::printf("seed %u: %dx%d in %.2f ms, %d food, %d unreachable, %d dead ends, %s%s\n",
+            mazeSeed, MazeLayout::width(rows), static_cast<int>(rows.size()), millis, food,
+            unreachable, deadEnds, mirrored ? "mirrored" : "not mirrored", ok ? "" : "  FAILED");
+    }
+
+    if (print) {
+        for (const std::string& row : rows) std::printf("%s\n", row.c_str());
+    }
+
+    if (!outPath.empty()) {
+        if (!MazeGenerator::save(rows, outPath)) {
+            std::fprintf(stderr, "Could not write %s\n", outPath.c_str());
+            return 1;
+        }
+        std::printf("Wrote %s\n", outPath.c_str());
+    }
+
+    if (!chunksPath.empty()) {
+        if (!ChunkedMazeFile::write(rows, chunksPath)) {
+            std::fprintf(stderr, "Could not write %s\n", chunksPath.c_str());
+            return 1;
+        }
+        std::printf("Wrote %s\n", chunksPath.c_str());
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,382 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Procedural Pac-Man mazes, for soak tests at sizes the stock map can't reach.
+//
+// MazeGenerator::generate(width, height, seed) returns rows in the Maze format
+// ('#' wall, '.' pellet, 'o' energizer, 'P' Pacman, '0'-'3' ghosts, ' ' open
+// without food): what a levelN.txt holds, so the result goes straight into
+// Maze(rows) or to disk with save().
+//
+// Corridors run on a lattice: tiles at odd row and odd column are junctions,
+// the tile between two neighbouring junctions is open or wall. Only the left
+// half is decided, every edge is opened together with its mirror image. A
+// randomised Kruskal pass over those edge pairs connects everything, a share of
+// the leftover edges is opened for loops, and any junction left with a single
+// exit gets a second one, so corridors never dead-end. A ghost house with an
+// open ring around it goes in the middle, tunnels run out to the side walls,
+// energizers sit in the corners and on a coarse grid.
+//
+// Every step is linear in the tile count (1000x1000 takes tens of
+// milliseconds) and the same seed gives the same maze everywhere: the
+// generator has its own PRNG instead of <random>'s distributions.
+
+// Checks on a finished layout, used by the generator tool and the level loader
+class MazeLayout {
+public:
+    static char tile(const std::vector<std::string>& rows, int row, int col) {
+        if (row < 0 || row >= static_cast<int>(rows.size()) || col < 0 ||
+            col >= static_cast<int>(rows[row].length())) return ' ';
+        return rows[row][col];
+    }
+
+    static int width(const std::vector<std::string>& rows) {
+        size_t width = 0;
+        for (const std::string& row : rows) width = std::max(width, row.length());
+        return static_cast<int>(width);
+    }
+
+    static bool isFood(char c) { return c == '.' || c == 'o'; }
+
+    // Pellets and energizers Pacman can't get to from 'P' (all of them if there is no P)
+    static int unreachableFood(const std::vector<std::string>& rows) {
+        int height = static_cast<int>(rows.size());
+        int cols = width(rows);
+        int food = 0, start = -1;
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                char c = tile(rows, row, col);
+                if (isFood(c)) food++;
+                else if (c == 'P') start = row * cols + col;
+            }
+        }
+        if (start < 0) return food;
+
+        // Flood fill the open tiles from Pacman's start
+        std::vector<char> seen(static_cast<size_t>(cols) * height, 0);
+        std::vector<int> open;
+        open.push_back(start);
+        seen[start] = 1;
+        int reached = 0;
+        while (!open.empty()) {
+            int cell = open.back();
+            open.pop_back();
+            int row = cell / cols, col = cell % cols;
+            if (isFood(tile(rows, row, col))) reached++;
+            const int steps[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+            for (const auto& step : steps) {
+                int r = row + step[0], k = col + step[1];
+                if (r < 0 || r >= height || k < 0 || k >= cols) continue;
+                if (seen[r * cols + k] || tile(rows, r, k) == '#') continue;
+                seen[r * cols + k] = 1;
+                open.push_back(r * cols + k);
+            }
+        }
+        return food - reached;
+    }
+
+    // Open tiles with at most one open neighbour: corridor ends, and tunnel
+    // mouths that come out against a wall. Left and right wrap round like the
+    // tunnels do; above the top and below the bottom is wall. Ghosts' spawns
+    // don't count, the pens in the house are meant to be left.
+    static int deadEnds(const std::vector<std::string>& rows) {
+        int height = static_cast<int>(rows.size());
+        int cols = width(rows);
+        auto open = [&](int row, int col) {
+            if (row < 0 || row >= height) return false;
+            return tile(rows, row, (col + cols) % cols) != '#';
+        };
+        int count = 0;
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                char c = tile(rows, row, col);
+                if (c == '#' || (c >= '0' && c <= '3')) continue;
+                int exits = open(row - 1, col) + open(row + 1, col) + open(row, col - 1) + open(row, col + 1);
+                if (exits <= 1) count++;
+            }
+        }
+        return count;
+    }
+
+    // Walls mirror left to right
+    static bool isMirrored(const std::vector<std::string>& rows) {
+        int cols = width(rows);
+        for (int row = 0; row < static_cast<int>(rows.size()); ++row) {
+            for (int col = 0; col < cols / 2; ++col) {
+                if ((tile(rows, row, col) == '#') != (tile(rows, row, cols - 1 - col) == '#')) return false;
+            }
+        }
+        return true;
+    }
+};
+
+class MazeGenerator {
+public:
+    static const int MIN_WIDTH = 15;
+    static const int MIN_HEIGHT = 15;
+    static const int HOUSE_WIDTH = 9;        // ghost house plus the open ring around it
+    static const int HOUSE_HEIGHT = 5;
+
+private:
+    // xorshift64*, seeded through splitmix64
+    uint64_t state;
+
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 2685821657736338717ull) >> 32);
+    }
+
+    // Uniform in [0, n)
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32);
+    }
+
+    std::vector<std::string> rows;
+    int width;                               // lattice part, odd
+    int height;
+    int nodeCols;
+    std::vector<int> parent;                 // union-find over junctions
+
+    explicit MazeGenerator(uint32_t seed) {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state = (z ^ (z >> 31)) | 1;
+    }
+
+    int node(int row, int col) const { return (row / 2) * nodeCols + col / 2; }
+
+    int find(int n) {
+        while (parent[n] != n) {
+            parent[n] = parent[parent[n]];
+            n = parent[n];
+        }
+        return n;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        parent[a] = b;
+        return true;
+    }
+
+    // Junctions on either side of the edge tile (row, col)
+    void ends(int row, int col, int& a, int& b) const {
+        if (row % 2 == 1) {
+            a = node(row, col - 1);
+            b = node(row, col + 1);
+        }
+        else {
+            a = node(row - 1, col);
+            b = node(row + 1, col);
+        }
+    }
+
+    // Open an edge tile and its mirror image. Returns whether that joined
+    // junctions that weren't connected yet.
+    bool openEdge(int row, int col) {
+        int mirror = width - 1 - col;
+        int a, b;
+        ends(row, col, a, b);
+        bool joined = unite(a, b);
+        ends(row, mirror, a, b);
+        joined = unite(a, b) || joined;
+        rows[row][col] = rows[row][mirror] = '.';
+        return joined;
+    }
+
+    bool isJoinedEdge(int row, int col) const {
+        int a, b;
+        ends(row, col, a, b);
+        int ra = a, rb = b;
+        while (parent[ra] != ra) ra = parent[ra];
+        while (parent[rb] != rb) rb = parent[rb];
+        return ra == rb;
+    }
+
+    void carveLattice() {
+        rows.assign(height, std::string(width, '#'));
+        nodeCols = (width - 1) / 2;
+        parent.resize(static_cast<size_t>(nodeCols) * ((height - 1) / 2));
+        for (size_t i = 0; i < parent.size(); ++i) parent[i] = static_cast<int>(i);
+
+        for (int row = 1; row < height - 1; row += 2) {
+            for (int col = 1; col < width - 1; col += 2) rows[row][col] = '.';
+        }
+
+        // Edge tiles of the left half, the centre column included
+        int centre = (width - 1) / 2;
+        std::vector<int> edges;
+        for (int row = 1; row < height - 1; ++row) {
+            for (int col = 1; col <= centre; ++col) {
+                if ((row % 2) != (col % 2)) edges.push_back(row * width + col);
+            }
+        }
+        for (size_t i = edges.size(); i > 1; --i) {
+            std::swap(edges[i - 1], edges[below(static_cast<uint32_t>(i))]);
+        }
+
+        // Kruskal: an edge pair goes in when either half joins two pieces
+        std::vector<int> spare;
+        spare.reserve(edges.size());
+        for (int edge : edges) {
+            int row = edge / width, col = edge % width;
+            if (isJoinedEdge(row, col) && isJoinedEdge(row, width - 1 - col)) spare.push_back(edge);
+            else openEdge(row, col);
+        }
+
+        // Loops: about a fifth of what the spanning tree left closed
+        for (int edge : spare) {
+            if (below(100) < 20) openEdge(edge / width, edge % width);
+        }
+
+        // Every junction of the left half with a single exit gets another one;
+        // opening only ever adds exits, so one pass leaves no dead ends
+        for (int row = 1; row < height - 1; row += 2) {
+            for (int col = 1; col <= centre; col += 2) {
+                int exits = 0;
+                int closed[4][2];
+                int closedCount = 0;
+                const int steps[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+                for (const auto& step : steps) {
+                    int r = row + step[0], k = col + step[1];
+                    if (r <= 0 || r >= height - 1 || k <= 0 || k >= width - 1) continue;
+                    if (rows[r][k] == '#') {
+                        closed[closedCount][0] = r;
+                        closed[closedCount][1] = k;
+                        closedCount++;
+                    }
+                    else {
+                        exits++;
+                    }
+                }
+                if (exits <= 1 && closedCount > 0) {
+                    int pick = static_cast<int>(below(closedCount));
+                    int r = closed[pick][0], k = closed[pick][1];
+                    openEdge(r, k <= centre ? k : width - 1 - k);
+                }
+            }
+        }
+    }
+
+    // Ghost house in the middle:
+    //     "         "   open ring, ghost 0 waits at the top centre
+    //     " ### ### "   door in the middle
+    //     " #1 2 3# "
+    //     " ####### "
+    //     "         "   open ring
+    // The ring stays open all round, so every corridor that ran through the
+    // area can still get around the house.
+    void placeHouse(int& houseTop) {
+        static const char* house[HOUSE_HEIGHT] = {
+            "    0    ",
+            " ### ### ",
+            " #1 2 3# ",
+            " ####### ",
+            "         "
+        };
+        int centreCol = (width - 1) / 2;
+        houseTop = (height - 1) / 2 - HOUSE_HEIGHT / 2;
+        int left = centreCol - HOUSE_WIDTH / 2;
+        for (int r = 0; r < HOUSE_HEIGHT; ++r) {
+            for (int c = 0; c < HOUSE_WIDTH; ++c) {
+                rows[houseTop + r][left + c] = house[r][c];
+            }
+        }
+    }
+
+    // Open the side walls on lattice rows spread down the maze. Tunnel mouths
+    // hold no food.
+    void placeTunnels() {
+        int tunnels = std::max(1, height / 40);
+        for (int i = 0; i < tunnels; ++i) {
+            int row = (height * (2 * i + 1) / (2 * tunnels)) | 1;
+            if (row >= height - 1) row -= 2;
+            if (rows[row][1] == '#') continue;
+            rows[row][0] = rows[row][width - 1] = ' ';
+        }
+    }
+
+    // The four corners, then one per 24x24 tiles on the left half and its mirror
+    void placeEnergizers() {
+        int centre = (width - 1) / 2;
+        auto energize = [&](int row, int col) {
+            if (rows[row][col] == '.') rows[row][col] = rows[row][width - 1 - col] = 'o';
+        };
+        energize(1, 1);
+        energize(height - 2, 1);
+        for (int row = 13; row < height - 1; row += 24) {
+            for (int col = 13; col <= centre; col += 24) energize(row, col);
+        }
+    }
+
+    // First open tile below the house on the centre column
+    void placePacman(int houseTop) {
+        int centreCol = (width - 1) / 2;
+        for (int row = houseTop + HOUSE_HEIGHT; row < height - 1; ++row) {
+            if (rows[row][centreCol] != '#') {
+                rows[row][centreCol] = 'P';
+                return;
+            }
+        }
+        rows[houseTop + HOUSE_HEIGHT - 1][centreCol] = 'P';
+    }
+
+    // Widen an odd maze by one column: the centre column again, next to
+    // itself. Walls stay mirrored and corridors crossing the centre get one
+    // tile longer; the copy leaves out the spawns.
+    static void doubleCentre(std::vector<std::string>& rows) {
+        for (std::string& row : rows) {
+            size_t centre = (row.size() - 1) / 2;
+            char copy = row[centre];
+            if (copy == 'P' || (copy >= '0' && copy <= '3')) copy = ' ';
+            row.insert(row.begin() + centre + 1, copy);
+        }
+    }
+
+public:
+    // A width x height maze (at least MIN_WIDTH x MIN_HEIGHT). The lattice
+    // needs odd sizes: an even width doubles the centre column, so the maze
+    // stays mirrored and the tunnels keep their mouths at the edges, and an
+    // even height gets an extra wall row at the bottom.
+    static std::vector<std::string> generate(int width, int height, uint32_t seed) {
+        width = std::max(width, static_cast<int>(MIN_WIDTH));
+        height = std::max(height, static_cast<int>(MIN_HEIGHT));
+
+        MazeGenerator generator(seed);
+        generator.width = width % 2 ? width : width - 1;
+        generator.height = height % 2 ? height : height - 1;
+        generator.carveLattice();
+
+        int houseTop = 0;
+        generator.placeHouse(houseTop);
+        generator.placeTunnels();
+        generator.placeEnergizers();
+        generator.placePacman(houseTop);
+
+        std::vector<std::string> rows;
+        rows.swap(generator.rows);
+        if (width % 2 == 0) doubleCentre(rows);
+        if (height % 2 == 0) rows.push_back(std::string(width, '#'));
+        return rows;
+    }
+
+    // One row per line, what LevelCampaign::readRows and Maze(rows) take
+    static bool save(const std::vector<std::string>& rows, const std::string& path) {
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open()) return false;
+        for (const std::string& row : rows) {
+            out.write(row.data(), static_cast<std::streamsize>(row.size()));
+            out.put('\n');
+        }
+        return out.good();
+    }
+};
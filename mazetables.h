@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Tables a maze is played from, worked out once from its rows.
+//
+// A layout is a grid of width x height tiles, row after row, short rows
+// padded with spaces. From it come:
+//   - a bitplane per row of walls and one of food, for the first 32 columns
+//     (the snapshot size, GameState::MAX_WIDTH),
+//   - a neighbour mask per tile,
+//   - the tiles of Pacman's and the four ghosts' spawns,
+//   - how many pellets and energizers there are.
+//
+// Every function here is constexpr. The stock maze (Maze::STOCK) is compiled
+// into a CompiledMaze while the game itself compiles. Its row widths, spawns
+// and reachability are static_asserts, and a Maze built from it only copies
+// the tables. Mazes loaded at run time (Maze(rows)) go through the same
+// functions, so both kinds end up with the same tables.
+
+class MazeTables {
+public:
+    static const int PLANE_BITS = 32;
+
+    // Neighbour mask bits, in the order of Direction (animation.h): the
+    // neighbour in direction d is bit 1 << d
+    static const uint8_t RIGHT_BIT = 1;
+    static const uint8_t UP_BIT = 2;
+    static const uint8_t DOWN_BIT = 4;
+    static const uint8_t LEFT_BIT = 8;
+
+    static constexpr bool isFood(char c) { return c == '.' || c == 'o'; }
+    static constexpr bool isSpawn(char c) { return c == 'P' || (c >= '0' && c <= '3'); }
+
+    static constexpr int length(const char* row) {
+        int n = 0;
+        while (row[n] != '\0') n++;
+        return n;
+    }
+
+    // One row of the grid from a row of the map, cut or padded to width
+    static constexpr void padRow(const char* row, int rowLength, int width, char* out) {
+        for (int col = 0; col < width; ++col) out[col] = col < rowLength ? row[col] : ' ';
+    }
+
+    static constexpr int countFood(const char* tiles, int count) {
+        int food = 0;
+        for (int i = 0; i < count; ++i) food += isFood(tiles[i]) ? 1 : 0;
+        return food;
+    }
+
+    // Index of the first tile that is c, -1 if there is none
+    static constexpr int find(const char* tiles, int count, char c) {
+        for (int i = 0; i < count; ++i) {
+            if (tiles[i] == c) return i;
+        }
+        return -1;
+    }
+
+    // Which neighbours are the same kind of tile as this one, wall next to
+    // wall or open next to open: a wall's connections in the wall mesh, or
+    // the ways out of a corridor tile. Outside the grid is neither.
+    static constexpr uint8_t neighbours(const char* tiles, int width, int height, int row, int col) {
+        bool wall = tiles[row * width + col] == '#';
+        uint8_t mask = 0;
+        if (col + 1 < width && (tiles[row * width + col + 1] == '#') == wall) mask |= RIGHT_BIT;
+        if (row > 0 && (tiles[(row - 1) * width + col] == '#') == wall) mask |= UP_BIT;
+        if (row + 1 < height && (tiles[(row + 1) * width + col] == '#') == wall) mask |= DOWN_BIT;
+        if (col > 0 && (tiles[row * width + col - 1] == '#') == wall) mask |= LEFT_BIT;
+        return mask;
+    }
+
+    static constexpr void buildNeighbours(const char* tiles, int width, int height, uint8_t* out) {
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) out[row * width + col] = neighbours(tiles, width, height, row, col);
+        }
+    }
+
+    // Wall and food bitplanes of rows [0, rows), bit c for column c < 32
+    static constexpr void buildPlanes(const char* tiles, int width, int rows, uint32_t* walls, uint32_t* food) {
+        int cols = width < PLANE_BITS ? width : PLANE_BITS;
+        for (int row = 0; row < rows; ++row) {
+            uint32_t wallBits = 0, foodBits = 0;
+            for (int col = 0; col < cols; ++col) {
+                char tile = tiles[row * width + col];
+                if (tile == '#') wallBits |= 1u << col;
+                else if (isFood(tile)) foodBits |= 1u << col;
+            }
+            walls[row] = wallBits;
+            food[row] = foodBits;
+        }
+    }
+};
+
+// A map compiled into MazeTables' tables, with what the static_asserts on it
+// check. W x H is the grid; rows longer than W are counted in longestRow and
+// cut.
+template <int W, int H>
+struct CompiledMaze {
+    static const int WIDTH = W;
+    static const int HEIGHT = H;
+
+    char tiles[W * H] = {};
+    uint8_t neighbours[W * H] = {};
+    uint32_t walls[H] = {};
+    uint32_t food[H] = {};
+    int pacman = -1;                   // tile index, -1 for none
+    int ghosts[4] = { -1, -1, -1, -1 };
+    int pacmen = 0;
+    int foodCount = 0;
+    int unreachableFood = 0;           // food not reachable from Pacman's start
+    int longestRow = 0;
+
+    constexpr explicit CompiledMaze(const char* const (&rows)[H]) {
+        for (int row = 0; row < H; ++row) {
+            int rowLength = MazeTables::length(rows[row]);
+            if (rowLength > longestRow) longestRow = rowLength;
+            MazeTables::padRow(rows[row], rowLength, W, tiles + row * W);
+        }
+        MazeTables::buildNeighbours(tiles, W, H, neighbours);
+        MazeTables::buildPlanes(tiles, W, H, walls, food);
+        foodCount = MazeTables::countFood(tiles, W * H);
+        pacman = MazeTables::find(tiles, W * H, 'P');
+        for (int i = 0; i < W * H; ++i) pacmen += tiles[i] == 'P' ? 1 : 0;
+        for (int i = 0; i < 4; ++i) ghosts[i] = MazeTables::find(tiles, W * H, static_cast<char>('0' + i));
+        unreachableFood = pacman < 0 ? foodCount : foodCount - reachableFood();
+    }
+
+    // Food a flood fill over open tiles from Pacman's start gets to
+    constexpr int reachableFood() const {
+        bool seen[W * H] = {};
+        int open[W * H] = {};
+        int count = 0, reached = 0;
+        open[count++] = pacman;
+        seen[pacman] = true;
+        while (count > 0) {
+            int cell = open[--count];
+            if (MazeTables::isFood(tiles[cell])) reached++;
+            int row = cell / W, col = cell % W;
+            const int next[4] = {
+                col + 1 < W ? cell + 1 : -1,
+                row > 0 ? cell - W : -1,
+                row + 1 < H ? cell + W : -1,
+                col > 0 ? cell - 1 : -1
+            };
+            for (int k : next) {
+                if (k < 0 || seen[k] || tiles[k] == '#') continue;
+                seen[k] = true;
+                open[count++] = k;
+            }
+        }
+        return reached;
+    }
+};
@@ -0,0 +1,396 @@
+// Microbenchmarks for the per-tick building blocks: maze queries, ghost movement
+// and collision, ghost behaviour scripts, the timer wheel, animation and the
+// menu dots. Runs
+// headless, no window or textures are created.
+//
+//     g++ -O2 -std=c++20 microbench.cpp -o microbench -lsfml-graphics -lsfml-window -lsfml-system
+//     ./microbench [--filter TEXT] [--min-time SECONDS] [--json FILE]
+//
+// Every case runs on the stock map and on synthetic 256x256 and 1024x1024 mazes
+// where the maze matters. Reported per operation: nanoseconds and heap bytes
+// allocated (from a global operator new counter). The best of three timed runs
+// is kept.
+#include "maze.h"
+#include "pacman.h"
+#include "Ghosts.h"
+#include "dots.h"
+#include "timerwheel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+static std::atomic<uint64_t> allocatedBytes(0);
+
+void* operator new(size_t size) {
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// Results are folded into this so the optimiser can't drop the calls
+static volatile uint64_t sink;
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+    double bytesPerOp;
+};
+
+struct Bench {
+    std::string name;
+    std::function<uint64_t(uint64_t)> run;   // does n operations, returns a checksum
+};
+
+static BenchResult measure(const Bench& bench, double minTime) {
+    using clock = std::chrono::steady_clock;
+
+    // Grow the batch until one takes a tenth of the time budget
+    uint64_t n = 1;
+    for (;;) {
+        auto start = clock::now();
+        sink = sink + bench.run(n);
+        double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        if (seconds >= minTime / 10 || n >= (1ull << 40)) break;
+        n *= 2;
+    }
+    n = std::max<uint64_t>(n * 10, 1);
+
+    BenchResult result = { bench.name, n, 1e30, 0 };
+    for (int round = 0; round < 3; ++round) {
+        uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+        auto start = clock::now();
+        sink = sink + bench.run(n);
+        double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        uint64_t bytes = allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+        double ns = seconds * 1e9 / n;
+        if (ns < result.nsPerOp) {
+            result.nsPerOp = ns;
+            result.bytesPerOp = static_cast<double>(bytes) / n;
+        }
+    }
+    return result;
+}
+
+// Open maze of the given size: border walls, a pillar on every even row and
+// column, pellets everywhere else, energizers in the corners, Pacman in the
+// middle and the four ghosts around him.
+static vector<string> syntheticMaze(int width, int height) {
+    vector<string> rows(height, string(width, '.'));
+    for (int row = 0; row < height; ++row) {
+        for (int col = 0; col < width; ++col) {
+            bool border = row == 0 || col == 0 || row == height - 1 || col == width - 1;
+            if (border || (row % 2 == 0 && col % 2 == 0)) rows[row][col] = '#';
+        }
+    }
+    rows[1][1] = rows[1][width - 2] = rows[height - 2][1] = rows[height - 2][width - 2] = 'o';
+
+    int midRow = (height / 2) | 1;
+    int midCol = (width / 2) | 1;
+    rows[midRow][midCol] = 'P';
+    rows[midRow][midCol - 2] = '0';
+    rows[midRow][midCol + 2] = '1';
+    rows[midRow - 2][midCol] = '2';
+    rows[midRow + 2][midCol] = '3';
+    return rows;
+}
+
+// A fixed spread of positions over the maze, cycled through by the cases so the
+// branches see realistic variety
+static vector<Vector2f> samplePositions(const Maze& maze, int count) {
+    vector<Vector2f> positions;
+    positions.reserve(count);
+    Vector2f offset = maze.getOffset();
+    float cellSize = static_cast<float>(Maze::getCellSize());
+    uint32_t state = 2463534242u;
+    for (int i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        float x = offset.x + (state % (maze.getWidth() * 4)) * cellSize / 4;
+        float y = offset.y + ((state >> 12) % (maze.getHeight() * 4)) * cellSize / 4;
+        positions.push_back(Vector2f(x, y));
+    }
+    return positions;
+}
+
+static const int POSITIONS = 1024;   // power of two, indexed with i & (POSITIONS - 1)
+
+static void addMazeBenches(vector<Bench>& benches, const string& label, Maze& maze) {
+    auto positions = std::make_shared<vector<Vector2f>>(samplePositions(maze, POSITIONS));
+    const Vector2f steps[4] = { { 2.f, 0.f }, { 0.f, -2.f }, { 0.f, 2.f }, { -2.f, 0.f } };
+
+    benches.push_back({ "Maze::getCell/" + label, [&maze, positions](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            Vector2i cell = maze.getCell((*positions)[i & (POSITIONS - 1)]);
+            sum += cell.x + cell.y;
+        }
+        return sum;
+    } });
+    benches.push_back({ "Maze::isWalkable/" + label, [&maze, positions](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += maze.isWalkable((*positions)[i & (POSITIONS - 1)]);
+        }
+        return sum;
+    } });
+    benches.push_back({ "Maze::canMove/" + label, [&maze, positions, steps](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += maze.canMove((*positions)[i & (POSITIONS - 1)], steps[i & 3]);
+        }
+        return sum;
+    } });
+    // Eats what it lands on, so after the first sweep this is the common
+    // no-pellet path (the one every tick takes between pellets)
+    benches.push_back({ "Maze::isFood/" + label, [&maze, positions](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += maze.isFood((*positions)[i & (POSITIONS - 1)]);
+        }
+        return sum;
+    } });
+    benches.push_back({ "Maze::getGhost/" + label, [&maze](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            Vector2i cell = maze.getGhost(static_cast<char>('0' + (i & 3)));
+            sum += cell.x + cell.y;
+        }
+        return sum;
+    } });
+    benches.push_back({ "Maze::getP/" + label, [&maze](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            Vector2i cell = maze.getP();
+            sum += cell.x + cell.y;
+        }
+        return sum;
+    } });
+    // A new round or life: the played tiles go back to the layout
+    benches.push_back({ "Maze::reset/" + label, [&maze](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            maze.reset();
+            sum += maze.getFoodCount();
+        }
+        return sum;
+    } });
+}
+
+static const map<Direction, int> FRAME_INDEXES = {
+    { RIGHT, 0 }, { UP, 1 }, { DOWN, 2 }, { LEFT, 3 }
+};
+
+static void addGhostMoveBenches(vector<Bench>& benches, const string& label, Maze& maze) {
+    Vector2i spawn = maze.getGhost('0');
+    Vector2f start = maze.cellToPosition(spawn.x, spawn.y);
+    auto ghost = std::make_shared<Ghost>("RANDOMGHOST.png", 4, 50, 50, start.x, start.y, 2.5f, 1.3f, FRAME_INDEXES);
+
+    // Wanders around the spawn point; a blocked move is as interesting as an open one
+    benches.push_back({ "Ghost::Move/" + label, [&maze, ghost](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += ghost->Move(static_cast<Direction>((i >> 4) & 3), maze);
+        }
+        return sum;
+    } });
+    benches.push_back({ "Ghost::isValidDirection/" + label, [&maze, ghost](uint64_t n) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += ghost->isValidDirection(maze, static_cast<Direction>(i & 3));
+        }
+        return sum;
+    } });
+}
+
+static void addCollisionBenches(vector<Bench>& benches, const Maze& maze) {
+    Vector2i spawn = maze.getGhost('0');
+    float x = spawn.x * 40.f + 20.f;
+    float y = spawn.y * 40.f + 20.f;
+
+    vector<std::pair<string, std::shared_ptr<Ghost>>> ghosts = {
+        { "Ghost", std::make_shared<Ghost>("RANDOMGHOST.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+        { "RingGhost", std::make_shared<RingGhost>("RINGGHOST.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+        { "TeleporterGhost", std::make_shared<TeleporterGhost>("TELEPORTER.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+        { "PhantomGhost", std::make_shared<PhantomGhost>("PHANTOM.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+        { "AmbusherGhost", std::make_shared<AmbusherGhost>("AMBUSHER.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+        { "TimeStopGhost", std::make_shared<TimeStopGhost>("TIMESTOP.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+        { "ChaserGhost", std::make_shared<ChaserGhost>("CHASER.png", 4, 50, 50, x, y, 2.5f, 1.3f, FRAME_INDEXES) },
+    };
+
+    // Pacman positions from on top of the ghost to a few tiles away, so both
+    // outcomes are measured
+    auto targets = std::make_shared<vector<Vector2f>>();
+    for (int i = 0; i < POSITIONS; ++i) {
+        targets->push_back(Vector2f(x + (i % 17 - 8) * 10.f, y + (i / 17 % 17 - 8) * 10.f));
+    }
+
+    for (auto& entry : ghosts) {
+        std::shared_ptr<Ghost> ghost = entry.second;
+        benches.push_back({ entry.first + "::GhostCollision", [ghost, targets](uint64_t n) {
+            const Ghost& g = *ghost;   // through the base class, like the game loop
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                sum += g.GhostCollision((*targets)[i & (POSITIONS - 1)]);
+            }
+            return sum;
+        } });
+    }
+}
+
+// Behaviour scripts (behaviour.h): an Update that mostly doesn't wake the
+// script, and restarting one from a snapshot the way rewind does, which should
+// not touch the heap
+static void addBehaviourBenches(vector<Bench>& benches) {
+    auto teleporter = std::make_shared<TeleporterGhost>("TELEPORTER.png", 4, 50, 50, 100.f, 100.f, 2.5f, 1.3f, FRAME_INDEXES);
+    benches.push_back({ "TeleporterGhost::Update", [teleporter](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            teleporter->Update(1.f / 60.f);
+        }
+        return static_cast<uint64_t>(teleporter->getSprite().getColor().a);
+    } });
+
+    auto chaser = std::make_shared<ChaserGhost>("CHASER.png", 4, 50, 50, 100.f, 100.f, 2.5f, 1.3f, FRAME_INDEXES);
+    auto state = std::make_shared<GhostState>();
+    chaser->Update(12.5f);
+    chaser->saveState(*state);
+    benches.push_back({ "ChaserGhost::loadState", [chaser, state](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            chaser->loadState(*state);
+        }
+        return static_cast<uint64_t>(chaser->getIsRaging());
+    } });
+}
+
+// Timer wheel (timerwheel.h) with 10000 timers pending, each firing every
+// 12 to 1200 ticks and scheduling its next turn: one operation is one tick.
+// A tick should cost what fires in it, not what is pending.
+struct RearmingTimers {
+    TimerWheel wheel;
+    uint64_t fired = 0;
+
+    void schedule(uint32_t period) {
+        wheel.schedule(period, [this](uint32_t p) {
+            fired++;
+            schedule(p);
+        }, period);
+    }
+};
+
+static void addTimerBenches(vector<Bench>& benches) {
+    const uint32_t TIMERS = 10000;
+    auto timers = std::make_shared<RearmingTimers>();
+    for (uint32_t i = 0; i < TIMERS; ++i) {
+        timers->schedule(12 + (i * 2654435761u) % 1189);
+    }
+    benches.push_back({ "TimerWheel::advance/" + to_string(TIMERS) + " timers", [timers](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            timers->wheel.advance();
+        }
+        return timers->fired;
+    } });
+}
+
+static void addAnimationBenches(vector<Bench>& benches) {
+    auto animation = std::make_shared<Animation>(0.1f);
+    auto sprite = std::make_shared<Sprite>();
+    for (int dir = 0; dir < 4; ++dir) {
+        for (int frame = 0; frame < 4; ++frame) {
+            animation->addDirectionalFrame(static_cast<Direction>(dir), IntRect(frame * 50, dir * 50, 50, 50));
+        }
+    }
+
+    benches.push_back({ "Animation::update", [animation, sprite](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            animation->update(1.f / 60.f, static_cast<Direction>((i >> 6) & 3), *sprite);
+        }
+        return static_cast<uint64_t>(sprite->getTextureRect().left);
+    } });
+
+    // The menu's full set of background dots, one call per frame
+    auto dots = std::make_shared<vector<Dot>>();
+    generateBackgroundDots(*dots, 960, 1050);
+    benches.push_back({ "updateDots/" + to_string(dots->size()) + " dots", [dots](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            updateDots(*dots, 1.f / 60.f, 1050);
+        }
+        return static_cast<uint64_t>((*dots)[0].shape.getPosition().y);
+    } });
+}
+
+int main(int argc, char** argv) {
+    string filter, jsonPath;
+    double minTime = 0.25;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--min-time" && hasValue) minTime = std::atof(argv[++i]);
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: microbench [--filter TEXT] [--min-time SECONDS] [--json FILE]\n");
+            return 2;
+        }
+    }
+
+    Ghost::headless() = true;
+
+    Maze stock;
+    Maze medium(syntheticMaze(256, 256));
+    Maze large(syntheticMaze(1024, 1024));
+    vector<std::pair<string, Maze*>> mazes = {
+        { "stock", &stock }, { "256x256", &medium }, { "1024x1024", &large }
+    };
+
+    vector<Bench> benches;
+    for (auto& m : mazes) addMazeBenches(benches, m.first, *m.second);
+    for (auto& m : mazes) addGhostMoveBenches(benches, m.first, *m.second);
+    addCollisionBenches(benches, stock);
+    addBehaviourBenches(benches);
+    addTimerBenches(benches);
+    addAnimationBenches(benches);
+
+    vector<BenchResult> results;
+    std::printf("%-40s %14s %10s %14s\n", "benchmark", "ns/op", "B/op", "iterations");
+    for (const Bench& bench : benches) {
+        if (!filter.empty() && bench.name.find(filter) == string::npos) continue;
+        BenchResult r = measure(bench, minTime);
+        results.push_back(r);
+        std::printf("%-40s %14.2f %10.1f %14llu\n", r.name.c_str(), r.nsPerOp, r.bytesPerOp,
+            static_cast<unsigned long long>(r.iterations));
+        std::fflush(stdout);
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            char line[256];
+            std::snprintf(line, sizeof(line), "  {\"name\": \"%s\", \"ns_per_op\": %.3f, \"bytes_per_op\": %.3f, \"iterations\": %llu}%s\n",
+                r.name.c_str(), r.nsPerOp, r.bytesPerOp, static_cast<unsigned long long>(r.iterations),
+                i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+        out << "]\n";
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "pacman_env.h"
+#include "trainingenv.h"
+
+struct PacmanEnv {
+    TrainingEnv env;
+    explicit PacmanEnv(int numEnvs) : env(numEnvs) {}
+};
+
+PacmanEnv* pacman_env_create(int32_t num_envs) {
+    if (num_envs <= 0) return nullptr;
+    return new PacmanEnv(num_envs);
+}
+
+void pacman_env_destroy(PacmanEnv* env) {
+    delete env;
+}
+
+void pacman_env_obs_shape(const PacmanEnv* env, int32_t* planes, int32_t* height, int32_t* width) {
+    if (planes) *planes = TrainingEnv::PLANES;
+    if (height) *height = env->env.getHeight();
+    if (width) *width = env->env.getWidth();
+}
+
+int32_t pacman_env_num_ghosts(const PacmanEnv*) {
+    return TrainingEnv::GHOSTS;
+}
+
+void pacman_env_reset(PacmanEnv* env, uint64_t seed, uint8_t* obs) {
+    env->env.reset(seed, obs);
+}
+
+void pacman_env_step(PacmanEnv* env, const int32_t* pacman_actions, const int32_t* ghost_actions,
+    uint8_t* obs, float* rewards, uint8_t* dones) {
+    env->env.step(pacman_actions, ghost_actions, obs, rewards, dones);
+}
@@ -0,0 +1,41 @@
+#pragma once
+// C ABI over TrainingEnv (trainingenv.h) for external trainers.
+//
+// Build as a shared library next to the game sources, e.g. on Linux:
+//     g++ -O2 -std=c++20 -shared -fPIC pacman_env.cpp -o libpacman_env.so -lsfml-graphics -lsfml-system
+// and load it from Python with ctypes or cffi. All buffers are owned by the
+// caller and written in place, nothing is copied behind its back.
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define PACMAN_ENV_API __declspec(dllexport)
+#else
+#define PACMAN_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PacmanEnv PacmanEnv;
+
+// Returns null if num_envs is not positive
+PACMAN_ENV_API PacmanEnv* pacman_env_create(int32_t num_envs);
+PACMAN_ENV_API void pacman_env_destroy(PacmanEnv* env);
+
+// Observation shape of a single environment: planes x height x width, uint8
+PACMAN_ENV_API void pacman_env_obs_shape(const PacmanEnv* env, int32_t* planes, int32_t* height, int32_t* width);
+PACMAN_ENV_API int32_t pacman_env_num_ghosts(const PacmanEnv* env);
+
+// obs: num_envs * planes * height * width bytes, may be null
+PACMAN_ENV_API void pacman_env_reset(PacmanEnv* env, uint64_t seed, uint8_t* obs);
+
+// pacman_actions: num_envs entries (0 right, 1 up, 2 down, 3 left, -1 keep going)
+// ghost_actions: num_envs * num_ghosts entries, or null for the built-in wandering
+// rewards: num_envs floats, dones: num_envs bytes; obs as in pacman_env_reset
+PACMAN_ENV_API void pacman_env_step(PacmanEnv* env, const int32_t* pacman_actions, const int32_t* ghost_actions,
+    uint8_t* obs, float* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
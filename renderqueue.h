@@ -0,0 +1,205 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Per-frame render queue.
+//
+// Instead of drawing straight to the window, the maze, ghosts and Pacman submit
+// small draw commands (texture region, transform, tint, layer) while they are
+// walked. flush() sorts them by layer and then texture and turns every run of
+// the same texture into one triangle-list draw, so a frame of the game is a
+// handful of draw calls no matter how many wall segments, pellets or ghosts
+// there are. Text (HUD, menus) is still drawn directly after the flush.
+//
+// Ghost sprite sheets live in one TextureAtlas so all ghosts share a texture
+// and batch together.
+
+enum RenderLayer : int16_t {
+    LAYER_MAZE = 0,
+    LAYER_PELLETS = 10,
+    LAYER_GHOSTS = 20,
+    LAYER_PACMAN = 30,
+    LAYER_OVERLAY = 40
+};
+
+struct DrawCommand {
+    enum Shape : uint8_t { QUAD, DISC };
+
+    const sf::Texture* texture;   // null for flat colour
+    sf::FloatRect region;         // QUAD: texture rect (or size when untextured); DISC: centre and radius in left/top/width
+    sf::Transform transform;
+    sf::Color tint;
+    int16_t layer;
+    uint8_t shape;
+    uint32_t order;               // submission order, keeps the sort stable
+};
+
+// Sprite sheets stacked into one texture. Regions never move once handed out,
+// the texture just grows downwards as sheets are added.
+class TextureAtlas {
+private:
+    sf::Texture texture;
+    sf::Image image;
+    std::map<std::string, sf::IntRect> regions;
+
+public:
+    // Region of the sheet in the atlas, loading it on first use. Empty rect if
+    // the file can't be loaded.
+    sf::IntRect add(const std::string& path) {
+        auto found = regions.find(path);
+        if (found != regions.end()) return found->second;
+
+        sf::Image sheet;
+        if (!sheet.loadFromFile(path)) return regions[path] = sf::IntRect();
+
+        sf::Vector2u oldSize = image.getSize();
+        sf::Vector2u sheetSize = sheet.getSize();
+        sf::Image grown;
+        grown.create(std::max(oldSize.x, sheetSize.x), oldSize.y + sheetSize.y, sf::Color::Transparent);
+        if (oldSize.y > 0) grown.copy(image, 0, 0);
+        grown.copy(sheet, 0, oldSize.y);
+        image = grown;
+        texture.loadFromImage(image);
+
+        sf::IntRect region(0, static_cast<int>(oldSize.y), static_cast<int>(sheetSize.x), static_cast<int>(sheetSize.y));
+        return regions[path] = region;
+    }
+
+    const sf::Texture& getTexture() const { return texture; }
+};
+
+class RenderQueue {
+public:
+    static const int DISC_SEGMENTS = 16;
+
+    struct Stats {
+        unsigned commands = 0;
+        unsigned drawCalls = 0;
+        unsigned vertices = 0;
+    };
+
+private:
+    std::vector<DrawCommand> commands;
+    std::vector<uint32_t> sorted;
+    sf::VertexArray vertices;
+    Stats last;
+
+    void emitQuad(const DrawCommand& c) {
+        float w = c.region.width, h = c.region.height;
+        sf::Vector2f corners[4] = {
+            c.transform.transformPoint(0, 0), c.transform.transformPoint(w, 0),
+            c.transform.transformPoint(w, h), c.transform.transformPoint(0, h)
+        };
+        sf::Vector2f uv[4];
+        if (c.texture) {
+            float l = c.region.left, t = c.region.top;
+            uv[0] = sf::Vector2f(l, t); uv[1] = sf::Vector2f(l + w, t);
+            uv[2] = sf::Vector2f(l + w, t + h); uv[3] = sf::Vector2f(l, t + h);
+        }
+        static const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i : order) {
+            vertices.append(sf::Vertex(corners[i], c.tint, uv[i]));
+        }
+    }
+
+    void emitDisc(const DrawCommand& c) {
+        sf::Vector2f centre = c.transform.transformPoint(c.region.left, c.region.top);
+        float radius = c.region.width;
+        const float step = 2.f * 3.14159265f / DISC_SEGMENTS;
+        sf::Vector2f previous(centre.x + radius, centre.y);
+        for (int i = 1; i <= DISC_SEGMENTS; ++i) {
+            sf::Vector2f next(centre.x + radius * std::cos(step * i), centre.y + radius * std::sin(step * i));
+            vertices.append(sf::Vertex(centre, c.tint));
+            vertices.append(sf::Vertex(previous, c.tint));
+            vertices.append(sf::Vertex(next, c.tint));
+            previous = next;
+        }
+    }
+
+public:
+    RenderQueue() : vertices(sf::Triangles) {
+        commands.reserve(1024);
+        sorted.reserve(1024);
+    }
+
+    // Textured sprite, uses the sprite's own texture rect, transform and colour
+    void submit(const sf::Sprite& sprite, int16_t layer) {
+        const sf::Texture* texture = sprite.getTexture();
+        sf::IntRect rect = sprite.getTextureRect();
+        if (!texture || rect.width == 0 || rect.height == 0) return;
+        commands.push_back({ texture, sf::FloatRect(rect), sprite.getTransform(), sprite.getColor(),
+            layer, DrawCommand::QUAD, static_cast<uint32_t>(commands.size()) });
+    }
+
+    // Flat coloured rectangle
+    void submitRect(const sf::FloatRect& rect, const sf::Color& color, int16_t layer) {
+        sf::Transform transform;
+        transform.translate(rect.left, rect.top);
+        commands.push_back({ nullptr, sf::FloatRect(0, 0, rect.width, rect.height), transform, color,
+            layer, DrawCommand::QUAD, static_cast<uint32_t>(commands.size()) });
+    }
+
+    // Flat coloured circle
+    void submitDisc(const sf::Vector2f& centre, float radius, const sf::Color& color, int16_t layer) {
+        commands.push_back({ nullptr, sf::FloatRect(centre.x, centre.y, radius, radius), sf::Transform::Identity, color,
+            layer, DrawCommand::DISC, static_cast<uint32_t>(commands.size()) });
+    }
+
+    // Commands recorded by another queue (see takeCommands), in their order
+    void submit(const std::vector<DrawCommand>& recorded) {
+        for (const DrawCommand& c : recorded) {
+            commands.push_back(c);
+            commands.back().order = static_cast<uint32_t>(commands.size() - 1);
+        }
+    }
+
+    // Hand the submitted commands over instead of drawing them, e.g. to draw
+    // them on another thread. out's old contents are dropped, its storage reused.
+    void takeCommands(std::vector<DrawCommand>& out) {
+        out.swap(commands);
+        commands.clear();
+    }
+
+    // Draw everything submitted since the last flush, in as few draw calls as
+    // layer order allows, and start a new frame
+    void flush(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) {
+        sorted.resize(commands.size());
+        for (uint32_t i = 0; i < commands.size(); ++i) sorted[i] = i;
+        std::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b) {
+            const DrawCommand& ca = commands[a];
+            const DrawCommand& cb = commands[b];
+            if (ca.layer != cb.layer) return ca.layer < cb.layer;
+            if (ca.texture != cb.texture) return ca.texture < cb.texture;
+            return ca.order < cb.order;
+        });
+
+        Stats stats;
+        stats.commands = static_cast<unsigned>(commands.size());
+        size_t i = 0;
+        while (i < sorted.size()) {
+            const sf::Texture* texture = commands[sorted[i]].texture;
+            vertices.clear();
+            // Runs only break on a texture change; layer order is already fixed by the sort
+            for (; i < sorted.size() && commands[sorted[i]].texture == texture; ++i) {
+                const DrawCommand& c = commands[sorted[i]];
+                if (c.shape == DrawCommand::DISC) emitDisc(c);
+                else emitQuad(c);
+            }
+            states.texture = texture;
+            target.draw(vertices, states);
+            stats.drawCalls++;
+            stats.vertices += static_cast<unsigned>(vertices.getVertexCount());
+        }
+
+        commands.clear();
+        last = stats;
+    }
+
+    // Counters of the last flush
+    const Stats& getStats() const { return last; }
+};
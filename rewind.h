@@ -0,0 +1,223 @@
+#pragma once
+#include "gamestate.h"
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <chrono>
+
+// Ring buffer holding the last few seconds of play as per-tick GameState deltas.
+//
+// Every tick the new snapshot is XOR'ed word by word against the previous one.
+// Most words don't change between ticks and the ones that do (positions, timers)
+// only flip low bits, so each record is written as pairs of
+//     varint(number of unchanged words skipped), varint(xor of the changed word)
+// closed by a zero skip past the end. Every KEYFRAME_INTERVAL ticks a record is
+// encoded against an all-zero state instead, so it can be decoded on its own and
+// old records can be dropped from the front without breaking the chain.
+//
+// 60 s at 60 ticks/s of the stock maze with four ghosts comes to about 150 KB.
+//
+// A maze too big for GameState's planes also has each tick's PelletPlane kept
+// whole, outside the ring: one pointer per 64x64 chunk, and the chunks Pacman
+// ate from since the tick before.
+class RewindBuffer {
+public:
+    static const int WORDS = (sizeof(GameState) + 3) / 4;
+    static const int KEYFRAME_INTERVAL = 60;   // one second at the game's 60 fps
+
+private:
+    struct Record {
+        uint32_t tick;
+        uint64_t offset;     // absolute byte position, ring index is offset % capacity
+        uint32_t size;
+        bool keyframe;
+        uint32_t plane;      // slot in planes
+    };
+
+    std::vector<uint8_t> ring;
+    uint64_t writePos;
+    std::deque<Record> records;
+    size_t maxTicks;
+    std::vector<PelletPlane> planes;     // a slot per record kept and one to write, used in turn
+    size_t nextPlane;
+
+    uint32_t previous[WORDS];
+    bool hasPrevious;
+    int sinceKeyframe;
+
+    std::vector<uint8_t> scratch;
+    float lastWriteMicros;
+
+    static void toWords(const GameState& state, uint32_t* words) {
+        words[WORDS - 1] = 0;
+        std::memcpy(words, &state, sizeof(GameState));
+    }
+
+    static void fromWords(const uint32_t* words, GameState& state) {
+        std::memcpy(&state, words, sizeof(GameState));
+    }
+
+    static void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint8_t byteAt(uint64_t pos) const { return ring[pos % ring.size()]; }
+
+    uint32_t getVarint(uint64_t& pos) const {
+        uint32_t value = 0;
+        int shift = 0;
+        uint8_t b;
+        do {
+            b = byteAt(pos++);
+            value |= static_cast<uint32_t>(b & 0x7F) << shift;
+            shift += 7;
+        } while ((b & 0x80) && shift < 35);
+        return value;
+    }
+
+    // Apply one record on top of words (all zero first for a keyframe)
+    void decodeRecord(const Record& rec, uint32_t* words) const {
+        if (rec.keyframe) std::memset(words, 0, sizeof(uint32_t) * WORDS);
+        uint64_t pos = rec.offset;
+        uint64_t end = rec.offset + rec.size;
+        int index = 0;
+        while (pos < end) {
+            index += static_cast<int>(getVarint(pos));
+            if (index >= WORDS) break;
+            words[index++] ^= getVarint(pos);
+        }
+    }
+
+    // Drop records whose bytes the next write would overwrite, then any deltas
+    // left at the front without their keyframe
+    void makeRoom(size_t bytes) {
+        while (!records.empty() && writePos + bytes > records.front().offset + ring.size()) {
+            records.pop_front();
+        }
+        while (!records.empty() && (records.size() > maxTicks || !records.front().keyframe)) {
+            records.pop_front();
+            while (!records.empty() && !records.front().keyframe) records.pop_front();
+        }
+    }
+
+    int findRecord(uint32_t tick) const {
+        int lo = 0, hi = static_cast<int>(records.size()) - 1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            if (records[mid].tick == tick) return mid;
+            if (records[mid].tick < tick) lo = mid + 1;
+            else hi = mid - 1;
+        }
+        return -1;
+    }
+
+public:
+    // seconds of history kept at the given tick rate; capacityBytes bounds the ring
+    RewindBuffer(float seconds = 60.f, int tickRate = 60, size_t capacityBytes = 512 * 1024)
+        : ring(capacityBytes),
+        writePos(0),
+        maxTicks(static_cast<size_t>(seconds * tickRate)),
+        planes(maxTicks + 2),
+        nextPlane(0),
+        hasPrevious(false),
+        sinceKeyframe(0),
+        lastWriteMicros(0.f)
+    {
+        scratch.reserve(WORDS * 10);
+    }
+
+    void clear() {
+        records.clear();
+        for (PelletPlane& plane : planes) plane = PelletPlane();
+        writePos = 0;
+        hasPrevious = false;
+        sinceKeyframe = 0;
+    }
+
+    // Append the state of one tick, with its maze's food if the maze is too
+    // big for the state's planes. Ticks must be increasing.
+    void record(const GameState& state, const PelletPlane& food) {
+        auto start = std::chrono::steady_clock::now();
+
+        uint32_t current[WORDS];
+        toWords(state, current);
+
+        bool keyframe = !hasPrevious || sinceKeyframe >= KEYFRAME_INTERVAL - 1;
+        scratch.clear();
+        int last = 0;
+        for (int i = 0; i < WORDS; ++i) {
+            uint32_t diff = keyframe ? current[i] : current[i] ^ previous[i];
+            if (diff == 0) continue;
+            putVarint(scratch, static_cast<uint32_t>(i - last));
+            putVarint(scratch, diff);
+            last = i + 1;
+        }
+        putVarint(scratch, static_cast<uint32_t>(WORDS - last));   // terminator
+
+        makeRoom(scratch.size());
+        size_t capacity = ring.size();
+        size_t at = static_cast<size_t>(writePos % capacity);
+        size_t first = std::min(scratch.size(), capacity - at);
+        std::memcpy(&ring[at], scratch.data(), first);
+        if (first < scratch.size()) std::memcpy(&ring[0], scratch.data() + first, scratch.size() - first);
+
+        uint32_t plane = static_cast<uint32_t>(nextPlane);
+        planes[plane] = food;
+        nextPlane = (nextPlane + 1) % planes.size();
+        records.push_back({ state.tick, writePos, static_cast<uint32_t>(scratch.size()), keyframe, plane });
+        writePos += scratch.size();
+
+        std::memcpy(previous, current, sizeof(previous));
+        hasPrevious = true;
+        sinceKeyframe = keyframe ? 0 : sinceKeyframe + 1;
+
+        lastWriteMicros = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Rebuild the state of a recorded tick. Returns false if it's no longer held.
+    bool restore(uint32_t tick, GameState& out, PelletPlane& food) const {
+        int index = findRecord(tick);
+        if (index < 0) return false;
+
+        int key = index;
+        while (key > 0 && !records[key].keyframe) key--;
+        if (!records[key].keyframe) return false;
+
+        uint32_t words[WORDS];
+        for (int i = key; i <= index; ++i) {
+            decodeRecord(records[i], words);
+        }
+        fromWords(words, out);
+        food = planes[records[index].plane];
+        return true;
+    }
+
+    // Forget everything after tick, so play can resume from a scrubbed position
+    void truncateAfter(uint32_t tick) {
+        while (!records.empty() && records.back().tick > tick) {
+            writePos = records.back().offset;
+            nextPlane = records.back().plane;
+            records.pop_back();
+        }
+        // The next record is encoded against whatever is recorded next, not
+        // against the dropped future, so start a fresh keyframe
+        hasPrevious = false;
+    }
+
+    bool empty() const { return records.empty(); }
+    uint32_t oldestTick() const { return records.empty() ? 0 : records.front().tick; }
+    uint32_t newestTick() const { return records.empty() ? 0 : records.back().tick; }
+    size_t tickCount() const { return records.size(); }
+
+    size_t bytesUsed() const {
+        if (records.empty()) return 0;
+        return static_cast<size_t>(writePos - records.front().offset);
+    }
+
+    float getLastWriteMicros() const { return lastWriteMicros; }
+};
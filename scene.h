@@ -0,0 +1,156 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Scene stack.
+//
+// Every screen (menu, instructions, ghost abilities, the round, game over) is a
+// Scene. Only the top scene gets events, updates and draws. It pushes, pops or
+// replaces scenes through the stack; those changes take effect between frames.
+//
+// A scene declares how often it needs a new frame:
+// - FULL_RATE: every frame, paced by the frame pacer (gameplay)
+// - N > 0: N frames per second, the loop sleeps in between
+// - 0: static, the loop blocks in waitEvent and only redraws after an event
+// After IDLE_SECONDS without input the scene's idleRate() applies instead, which
+// for the menu and game over screens is 0, so an unattended machine sits in
+// waitEvent instead of redrawing the window 60 times a second.
+
+class Scene {
+public:
+    static const int FULL_RATE = 1 << 16;
+
+    virtual ~Scene() {}
+
+    // Frames per second the scene animates at, 0 if nothing moves without input
+    virtual int updateRate() const = 0;
+
+    // Rate once nobody has touched the keyboard or mouse for a while
+    virtual int idleRate() const { return updateRate(); }
+
+    virtual void handleEvent(const sf::Event& event) {}
+
+    // dt is 0 for the redraw of a static scene
+    virtual void update(float dt) {}
+
+    virtual void draw(sf::RenderWindow& window) = 0;
+};
+
+class SceneStack {
+public:
+    static constexpr float IDLE_SECONDS = 60.f;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    enum Op { PUSH, POP, REPLACE };
+    struct Change {
+        Op op;
+        std::unique_ptr<Scene> scene;
+    };
+
+    std::vector<std::unique_ptr<Scene>> scenes;
+    std::vector<Change> changes;
+    std::deque<sf::Event> held;              // events taken while waiting, not handed out yet
+    bool redraw = true;                      // static scenes draw only when set
+    Clock::time_point lastFrame = Clock::now();
+    Clock::time_point lastInput = Clock::now();
+
+    static bool isInput(const sf::Event& event) {
+        return event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased ||
+            event.type == sf::Event::MouseMoved || event.type == sf::Event::MouseButtonPressed ||
+            event.type == sf::Event::TextEntered || event.type == sf::Event::JoystickButtonPressed;
+    }
+
+    // Move whatever the window has into held, true if anything arrived
+    bool drainWindow(sf::Window& window) {
+        sf::Event event;
+        bool any = false;
+        while (window.pollEvent(event)) {
+            held.push_back(event);
+            any = true;
+        }
+        return any;
+    }
+
+public:
+    void push(std::unique_ptr<Scene> scene) { changes.push_back({ PUSH, std::move(scene) }); }
+    void pop() { changes.push_back({ POP, nullptr }); }
+    void replace(std::unique_ptr<Scene> scene) { changes.push_back({ REPLACE, std::move(scene) }); }
+
+    // Apply the pushes and pops requested since the last call. A popped scene is
+    // destroyed here, never while one of its own methods is running.
+    void applyChanges() {
+        if (changes.empty()) return;
+        std::vector<Change> pending;
+        pending.swap(changes);
+        for (Change& change : pending) {
+            if ((change.op == POP || change.op == REPLACE) && !scenes.empty()) scenes.pop_back();
+            if (change.op == PUSH || change.op == REPLACE) scenes.push_back(std::move(change.scene));
+        }
+        redraw = true;
+    }
+
+    bool empty() const { return scenes.empty(); }
+    Scene* top() const { return scenes.empty() ? nullptr : scenes.back().get(); }
+
+    bool isIdle() const {
+        return std::chrono::duration<float>(Clock::now() - lastInput).count() >= IDLE_SECONDS;
+    }
+
+    // Rate of the top scene right now, after idling
+    int currentRate() const {
+        if (scenes.empty()) return 0;
+        return isIdle() ? scenes.back()->idleRate() : scenes.back()->updateRate();
+    }
+
+    // Block until the top scene needs a frame: an event arrived, a static scene
+    // must redraw, or the next frame of a slow scene is due. Scenes at or above
+    // pacedRate return at once, the frame pacer holds their rate.
+    void waitForFrame(sf::Window& window, int pacedRate) {
+        if (!held.empty() || redraw) return;
+        int rate = currentRate();
+        if (rate >= pacedRate) return;
+
+        if (rate <= 0) {
+            sf::Event event;
+            if (window.waitEvent(event)) held.push_back(event);
+            return;
+        }
+
+        // Sleep in short slices so input still wakes the loop early
+        Clock::time_point due = lastFrame + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / rate));
+        while (Clock::now() < due) {
+            if (drainWindow(window)) return;
+            Clock::duration slice = std::min<Clock::duration>(due - Clock::now(), std::chrono::milliseconds(10));
+            if (slice > Clock::duration::zero()) std::this_thread::sleep_for(slice);
+        }
+    }
+
+    // Next event for this frame, waiting ones first
+    bool pollEvent(sf::Window& window, sf::Event& event) {
+        if (held.empty() && !drainWindow(window)) return false;
+        event = held.front();
+        held.pop_front();
+        if (isInput(event)) lastInput = Clock::now();
+        redraw = true;
+        return true;
+    }
+
+    // Whether this frame is a redraw of a static scene (update with dt 0)
+    bool isStaticFrame() const {
+        return currentRate() <= 0;
+    }
+
+    // Call after display()
+    void frameDone() {
+        lastFrame = Clock::now();
+        redraw = false;
+    }
+};
@@ -0,0 +1,360 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Persistent scores and leaderboard.
+//
+// Every finished game is one fixed-size record appended to scores.log and
+// fsync'ed. A crash can at worst leave a torn record at the end, which fails
+// its checksum; open() cuts it off before anything new is appended.
+//
+// scores.idx holds the top LEADERBOARD_SIZE records plus how many log records
+// it has seen. It is rewritten through a temp file, fsync and rename, so it's
+// either the old or the new version. If it's missing, damaged or behind the
+// log (crash between the two writes), open() rebuilds it from the log.
+//
+// submit() updates the in-memory leaderboard right away and hands the disk
+// work to a background thread, so the game loop never waits on the disk. The
+// index is written from a second leaderboard of only the records already in
+// the log, so it never lists a score a crash could lose. Records the log
+// refuses go back to the front of the queue and are tried again.
+
+struct ScoreRecord {
+    static const int NAME_SIZE = 16;
+    static const int GHOST_NAME_SIZE = 12;
+    static const int MAX_GHOSTS = 4;
+
+    int64_t timestamp;                          // seconds since the epoch
+    int32_t score;
+    uint8_t ghostCount;
+    uint8_t won;
+    uint8_t reserved[2];
+    char name[NAME_SIZE];
+    char ghosts[MAX_GHOSTS][GHOST_NAME_SIZE];
+    uint32_t checksum;                          // crc32 of everything above
+
+    std::string getName() const { return std::string(name, strnlen(name, NAME_SIZE)); }
+    std::string getGhost(int i) const { return std::string(ghosts[i], strnlen(ghosts[i], GHOST_NAME_SIZE)); }
+};
+
+class ScoreStore {
+public:
+    static const int LEADERBOARD_SIZE = 10;
+
+private:
+    static const uint32_t INDEX_MAGIC = 0x58444953;   // "SIDX"
+    static const uint32_t INDEX_VERSION = 1;
+
+    struct IndexHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t count;              // leaderboard entries that follow
+        uint64_t logRecords;         // log records covered by this index
+        uint32_t checksum;           // crc32 of the entries
+        uint32_t reserved;
+    };
+
+    std::string logPath;
+    std::string indexPath;
+
+    static const int RETRY_SECONDS = 1;
+
+    std::mutex mutex;                 // guards everything below
+    std::vector<ScoreRecord> top;     // best first
+    std::vector<ScoreRecord> written; // the same over the log's records only, what the index holds
+    uint64_t logRecords = 0;
+    std::deque<ScoreRecord> pending;
+    bool stopping = false;
+    std::condition_variable wake;
+    std::thread writer;
+
+    static uint32_t crc32(const void* data, size_t size, uint32_t crc = 0) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= bytes[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+        }
+        return ~crc;
+    }
+
+    static uint32_t recordChecksum(const ScoreRecord& record) {
+        return crc32(&record, offsetof(ScoreRecord, checksum));
+    }
+
+    static bool better(const ScoreRecord& a, const ScoreRecord& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return a.timestamp < b.timestamp;   // earlier game keeps the place on a tie
+    }
+
+    static void insertTop(std::vector<ScoreRecord>& board, const ScoreRecord& record) {
+        auto at = std::upper_bound(board.begin(), board.end(), record, better);
+        if (at - board.begin() >= LEADERBOARD_SIZE) return;
+        board.insert(at, record);
+        if (board.size() > static_cast<size_t>(LEADERBOARD_SIZE)) board.pop_back();
+    }
+
+    // Flush stdio and the OS cache so the bytes are on disk
+    static bool syncFile(FILE* file) {
+        if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+    static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        if (std::rename(from.c_str(), to.c_str()) != 0) return false;
+        // Make the rename itself durable
+        std::string dir = to.find('/') == std::string::npos ? "." : to.substr(0, to.find_last_of('/'));
+        int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+        return true;
+#endif
+    }
+
+    // Valid records of the log, stopping at the first damaged one. damaged is
+    // set if anything follows them (a torn write).
+    std::vector<ScoreRecord> readLog(bool& damaged) const {
+        std::vector<ScoreRecord> records;
+        damaged = false;
+        FILE* file = std::fopen(logPath.c_str(), "rb");
+        if (!file) return records;
+        ScoreRecord record;
+        while (std::fread(&record, sizeof(record), 1, file) == 1) {
+            if (record.checksum != recordChecksum(record)) break;
+            records.push_back(record);
+        }
+        damaged = std::fseek(file, static_cast<long>(records.size() * sizeof(ScoreRecord)), SEEK_SET) == 0 &&
+            std::fgetc(file) != EOF;
+        std::fclose(file);
+        return records;
+    }
+
+    // Replace the log with just the given records, so new appends don't land
+    // behind a torn one
+    bool rewriteLog(const std::vector<ScoreRecord>& records) const {
+        std::string tempPath = logPath + ".tmp";
+        FILE* file = std::fopen(tempPath.c_str(), "wb");
+        if (!file) return false;
+        bool ok = (records.empty() || std::fwrite(records.data(), sizeof(ScoreRecord), records.size(), file) == records.size()) &&
+            syncFile(file);
+        ok = std::fclose(file) == 0 && ok;
+        return ok && replaceFile(tempPath, logPath);
+    }
+
+    bool readIndex(std::vector<ScoreRecord>& board, uint64_t& covered) const {
+        FILE* file = std::fopen(indexPath.c_str(), "rb");
+        if (!file) return false;
+        IndexHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+            header.magic == INDEX_MAGIC && header.version == INDEX_VERSION &&
+            header.recordSize == sizeof(ScoreRecord) && header.count <= LEADERBOARD_SIZE;
+        if (ok) {
+            board.resize(header.count);
+            ok = header.count == 0 || std::fread(board.data(), sizeof(ScoreRecord), header.count, file) == header.count;
+            ok = ok && crc32(board.data(), board.size() * sizeof(ScoreRecord)) == header.checksum;
+            covered = header.logRecords;
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    bool writeIndex(const std::vector<ScoreRecord>& board, uint64_t covered) const {
+        IndexHeader header = {};
+        header.magic = INDEX_MAGIC;
+        header.version = INDEX_VERSION;
+        header.recordSize = sizeof(ScoreRecord);
+        header.count = static_cast<uint32_t>(board.size());
+        header.logRecords = covered;
+        header.checksum = crc32(board.data(), board.size() * sizeof(ScoreRecord));
+
+        std::string tempPath = indexPath + ".tmp";
+        FILE* file = std::fopen(tempPath.c_str(), "wb");
+        if (!file) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+            (board.empty() || std::fwrite(board.data(), sizeof(ScoreRecord), board.size(), file) == board.size()) &&
+            syncFile(file);
+        ok = std::fclose(file) == 0 && ok;
+        return ok && replaceFile(tempPath, indexPath);
+    }
+
+    // Write record as the log's index-th, over whatever a failed attempt left
+    // there, so a retry doesn't land behind a torn record
+    bool writeLogRecord(const ScoreRecord& record, uint64_t index) const {
+        FILE* file = std::fopen(logPath.c_str(), "r+b");
+        if (!file && index == 0) file = std::fopen(logPath.c_str(), "wb");   // no log yet
+        if (!file) return false;
+        bool ok = std::fseek(file, static_cast<long>(index * sizeof(ScoreRecord)), SEEK_SET) == 0 &&
+            std::fwrite(&record, sizeof(record), 1, file) == 1 && syncFile(file);
+        return std::fclose(file) == 0 && ok;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) return;   // stopping and nothing left
+
+            std::deque<ScoreRecord> batch;
+            batch.swap(pending);
+            uint64_t position = logRecords;
+            lock.unlock();
+
+            // In order; the first record that fails and everything after it wait
+            size_t appended = 0;
+            while (appended < batch.size() && writeLogRecord(batch[appended], position + appended)) {
+                appended++;
+            }
+
+            lock.lock();
+            logRecords += appended;
+            for (size_t i = 0; i < appended; ++i) {
+                insertTop(written, batch[i]);
+            }
+            bool failed = appended < batch.size();
+            if (failed) {
+                std::fprintf(stderr, "Could not append to %s\n", logPath.c_str());
+                pending.insert(pending.begin(), batch.begin() + appended, batch.end());
+            }
+
+            if (appended > 0) {
+                std::vector<ScoreRecord> board = written;
+                uint64_t covered = logRecords;
+                lock.unlock();
+                if (!writeIndex(board, covered)) {
+                    std::fprintf(stderr, "Could not write %s\n", indexPath.c_str());
+                }
+                lock.lock();
+            }
+
+            if (failed) {
+                // Shutting down gets one more try, not an endless wait on the disk
+                if (stopping) {
+                    std::fprintf(stderr, "Giving up on %u scores\n", static_cast<unsigned>(pending.size()));
+                    return;
+                }
+                wake.wait_for(lock, std::chrono::seconds(RETRY_SECONDS), [this] { return stopping; });
+            }
+        }
+    }
+
+public:
+    ScoreStore(const std::string& logPath = "scores.log", const std::string& indexPath = "scores.idx")
+        : logPath(logPath), indexPath(indexPath) {
+    }
+
+    ~ScoreStore() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (writer.joinable()) writer.join();
+    }
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    // Load the leaderboard and start the writer thread. The index is trusted if
+    // it covers the whole log, otherwise it's rebuilt from the log.
+    void open() {
+        std::vector<ScoreRecord> board;
+        uint64_t covered = 0;
+        bool indexOk = readIndex(board, covered);
+
+        bool damaged = false;
+        std::vector<ScoreRecord> records = readLog(damaged);
+        if (damaged && !rewriteLog(records)) {
+            std::fprintf(stderr, "Could not repair %s\n", logPath.c_str());
+        }
+        if (!indexOk || covered != records.size()) {
+            board.clear();
+            for (const ScoreRecord& record : records) {
+                insertTop(board, record);
+            }
+            writeIndex(board, records.size());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            top = board;
+            written = board;
+            logRecords = records.size();
+        }
+        if (!writer.joinable()) writer = std::thread([this] { run(); });
+    }
+
+    // Build a record for a finished game
+    static ScoreRecord makeRecord(const std::string& name, int score, const std::vector<std::string>& ghosts, bool won) {
+        ScoreRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.timestamp = static_cast<int64_t>(std::time(nullptr));
+        record.score = score;
+        record.won = won ? 1 : 0;
+        std::strncpy(record.name, name.c_str(), ScoreRecord::NAME_SIZE);
+        record.ghostCount = static_cast<uint8_t>(std::min<size_t>(ghosts.size(), ScoreRecord::MAX_GHOSTS));
+        for (int i = 0; i < record.ghostCount; ++i) {
+            std::strncpy(record.ghosts[i], ghosts[i].c_str(), ScoreRecord::GHOST_NAME_SIZE);
+        }
+        return record;
+    }
+
+    // Record a finished game. Returns at once; the write happens on the writer thread.
+    void submit(ScoreRecord record) {
+        record.checksum = recordChecksum(record);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            insertTop(top, record);
+            pending.push_back(record);
+        }
+        wake.notify_one();
+    }
+
+    std::vector<ScoreRecord> leaderboard() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return top;
+    }
+
+    int best() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return top.empty() ? 0 : top.front().score;
+    }
+
+    bool empty() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return logRecords == 0 && pending.empty();
+    }
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// One recorded round: the ghost line-up, the seed the world ran with and the
+// input and frame time of every gameplay tick. GameWorld is deterministic for
+// a given seed, so feeding these back through GameWorld::update replays the
+// round exactly (bench_replay does this headless).
+//
+// File layout, little endian:
+//     "PMRS" u32 version, u32 seed, u8 ghost count, {u8 length, name bytes}...,
+//     u32 tick count, {f32 dt, u8 input}...
+
+// SessionTick::input holds the Direction pressed that tick plus one in the low
+// bits (0 when no direction key was pressed), and flags for debug keys
+static const uint8_t SESSION_DIRECTION_MASK = 0x07;
+static const uint8_t SESSION_SUPER_MODE = 0x08;   // debug key S
+
+struct SessionTick {
+    float dt;
+    uint8_t input;
+};
+
+class Session {
+public:
+    static const uint32_t VERSION = 8;    // 8: only flagged jumps skip the sweep, older rounds replay differently
+
+    std::vector<std::string> lineup;
+    uint32_t seed = 0;
+    std::vector<SessionTick> ticks;
+
+    void begin(const std::vector<std::string>& ghostLineup, uint32_t roundSeed) {
+        lineup = ghostLineup;
+        seed = roundSeed;
+        ticks.clear();
+        ticks.reserve(60 * 60 * 5);
+    }
+
+    void record(float dt, uint8_t input) {
+        ticks.push_back({ dt, input });
+    }
+
+    // Forget everything after the first n ticks (rewind and quickload)
+    void truncate(size_t n) {
+        if (n < ticks.size()) ticks.resize(n);
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open()) return false;
+
+        out.write("PMRS", 4);
+        writeU32(out, VERSION);
+        writeU32(out, seed);
+        uint8_t count = static_cast<uint8_t>(lineup.size());
+        out.write(reinterpret_cast<const char*>(&count), 1);
+        for (const auto& name : lineup) {
+            uint8_t length = static_cast<uint8_t>(name.size());
+            out.write(reinterpret_cast<const char*>(&length), 1);
+            out.write(name.data(), length);
+        }
+        writeU32(out, static_cast<uint32_t>(ticks.size()));
+        for (const auto& t : ticks) {
+            out.write(reinterpret_cast<const char*>(&t.dt), sizeof(float));
+            out.write(reinterpret_cast<const char*>(&t.input), 1);
+        }
+        return out.good();
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        char magic[4];
+        in.read(magic, 4);
+        if (!in || std::string(magic, 4) != "PMRS") return false;
+        if (readU32(in) != VERSION) return false;
+        seed = readU32(in);
+
+        uint8_t count = 0;
+        in.read(reinterpret_cast<char*>(&count), 1);
+        lineup.clear();
+        for (int i = 0; i < count && in; ++i) {
+            uint8_t length = 0;
+            in.read(reinterpret_cast<char*>(&length), 1);
+            std::string name(length, ' ');
+            in.read(&name[0], length);
+            lineup.push_back(name);
+        }
+
+        uint32_t tickCount = readU32(in);
+        ticks.clear();
+        ticks.reserve(tickCount);
+        for (uint32_t i = 0; i < tickCount && in; ++i) {
+            SessionTick t;
+            in.read(reinterpret_cast<char*>(&t.dt), sizeof(float));
+            in.read(reinterpret_cast<char*>(&t.input), 1);
+            ticks.push_back(t);
+        }
+        return static_cast<bool>(in) && ticks.size() == tickCount;
+    }
+
+private:
+    static void writeU32(std::ofstream& out, uint32_t value) {
+        out.write(reinterpret_cast<const char*>(&value), 4);
+    }
+
+    static uint32_t readU32(std::ifstream& in) {
+        uint32_t value = 0;
+        in.read(reinterpret_cast<char*>(&value), 4);
+        return value;
+    }
+};
@@ -0,0 +1,183 @@
+#pragma once
+#include "gamestate.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX     // keep std::min/std::max usable in headers included after this one
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Live game state published into shared memory once per tick, for bots and
+// analysis tools running as separate processes.
+//
+// The segment holds a small header and one GameState. Writes go through a
+// seqlock: the game bumps the sequence to odd, copies the state in, and bumps it
+// back to even. Readers copy the state out and retry if the sequence was odd or
+// moved underneath them, so the game loop never waits on a reader.
+//
+// Readers must check magic, version and stateSize before trusting the payload;
+// SHARED_STATE_VERSION goes up whenever GameState's layout changes.
+//
+// Only the GameState is published. For a maze bigger than its tile planes
+// (mazeWidth x mazeHeight past width x height) that is the top left corner;
+// the rest of the food stays in the game's PelletPlane.
+
+static const uint32_t SHARED_STATE_MAGIC = 0x50414353;   // "PACS"
+static const uint32_t SHARED_STATE_VERSION = 2;    // 2: mazeWidth, mazeHeight
+
+#ifdef _WIN32
+static const char* const SHARED_STATE_NAME = "Local\\pacman_state";
+#else
+static const char* const SHARED_STATE_NAME = "/pacman_state";
+#endif
+
+struct SharedStateBlock {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stateSize;      // sizeof(GameState) of the writer
+    std::atomic<uint32_t> sequence;
+    uint64_t publishCount;
+    GameState state;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock needs an address-free atomic");
+
+// Maps the segment, shared by the publisher and the reader
+class SharedStateMapping {
+protected:
+    SharedStateBlock* block = nullptr;
+#ifdef _WIN32
+    HANDLE mapping = nullptr;
+#else
+    bool owner = false;
+#endif
+
+    bool map(bool create) {
+#ifdef _WIN32
+        if (create) {
+            mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                sizeof(SharedStateBlock), SHARED_STATE_NAME);
+        }
+        else {
+            mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, SHARED_STATE_NAME);
+        }
+        if (!mapping) return false;
+        void* view = MapViewOfFile(mapping, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, sizeof(SharedStateBlock));
+        if (!view) {
+            CloseHandle(mapping);
+            mapping = nullptr;
+            return false;
+        }
+#else
+        int fd = create ? shm_open(SHARED_STATE_NAME, O_CREAT | O_RDWR, 0644)
+                        : shm_open(SHARED_STATE_NAME, O_RDONLY, 0);
+        if (fd < 0) return false;
+        if (create && ftruncate(fd, sizeof(SharedStateBlock)) != 0) {
+            close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, sizeof(SharedStateBlock), create ? PROT_READ | PROT_WRITE : PROT_READ,
+            MAP_SHARED, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) return false;
+        owner = create;
+#endif
+        block = static_cast<SharedStateBlock*>(view);
+        return true;
+    }
+
+    void unmap() {
+        if (!block) return;
+#ifdef _WIN32
+        UnmapViewOfFile(block);
+        CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        munmap(block, sizeof(SharedStateBlock));
+        if (owner) shm_unlink(SHARED_STATE_NAME);
+        owner = false;
+#endif
+        block = nullptr;
+    }
+
+public:
+    SharedStateMapping() = default;
+    SharedStateMapping(const SharedStateMapping&) = delete;
+    SharedStateMapping& operator=(const SharedStateMapping&) = delete;
+    ~SharedStateMapping() { unmap(); }
+
+    bool isOpen() const { return block != nullptr; }
+};
+
+// Game side. Creates the segment and writes one state per tick.
+class SharedStatePublisher : public SharedStateMapping {
+public:
+    bool open() {
+        if (isOpen()) return true;
+        if (!map(true)) return false;
+
+        block->sequence.store(1, std::memory_order_relaxed);   // odd until the first publish
+        block->magic = SHARED_STATE_MAGIC;
+        block->version = SHARED_STATE_VERSION;
+        block->stateSize = sizeof(GameState);
+        block->publishCount = 0;
+        return true;
+    }
+
+    void publish(const GameState& state) {
+        if (!block) return;
+        uint32_t seq = block->sequence.load(std::memory_order_relaxed);
+        if ((seq & 1u) == 0) seq++;
+        block->sequence.store(seq, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&block->state, &state, sizeof(GameState));
+        block->publishCount++;
+
+        block->sequence.store(seq + 1, std::memory_order_release);
+    }
+};
+
+// Tool side. Never blocks the game, a read just retries while a write is in flight.
+class SharedStateReader : public SharedStateMapping {
+public:
+    bool open() {
+        if (isOpen()) return true;
+        if (!map(false)) return false;
+        if (block->magic != SHARED_STATE_MAGIC || block->version != SHARED_STATE_VERSION ||
+            block->stateSize != sizeof(GameState)) {
+            unmap();
+            return false;
+        }
+        return true;
+    }
+
+    // Copy out a consistent state. Returns false if none was published yet or
+    // the writer kept it busy for maxRetries attempts.
+    bool read(GameState& out, uint64_t* publishCount = nullptr, int maxRetries = 1000) const {
+        if (!block) return false;
+        for (int attempt = 0; attempt < maxRetries; ++attempt) {
+            uint32_t before = block->sequence.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+
+            std::memcpy(&out, &block->state, sizeof(GameState));
+            uint64_t count = block->publishCount;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (block->sequence.load(std::memory_order_relaxed) == before) {
+                if (publishCount) *publishCount = count;
+                return true;
+            }
+        }
+        return false;
+    }
+};
@@ -0,0 +1,393 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "camera.h"
+#include "gameworld.h"
+#include "renderqueue.h"
+#include "latency.h"
+#include "framepacer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Simulation thread for a live round.
+//
+// While the round is playing, GameWorld belongs to the simulation thread. It
+// ticks at a fixed 60 Hz no matter how long the window thread spends drawing or
+// waiting for vsync. Key presses reach it through a lock-free single-producer
+// single-consumer queue, stamped with the time they were polled, and are applied
+// at the start of the next tick. After every tick the thread builds an immutable
+// WorldSnapshot (maze draw commands, sprites, HUD values) and publishes it
+// through a triple buffer; the window thread draws the newest one, blending
+// sprite positions between the last two ticks.
+//
+// With tracing on, every applied input is also reported back (InputTrace) so the
+// window thread can measure input-to-photon latency (see latency.h). In late-latch
+// mode the arrow keys are not taken from window events at all: the simulation
+// thread samples the keyboard itself right before each tick.
+//
+// Anything else that touches the world (quicksave, rewind, the life lost and
+// game over screens) calls stop() first, which joins the thread and hands the
+// world back to the caller.
+
+// Bounded queue for exactly one producer thread and one consumer thread
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+    T items[Capacity];
+    alignas(64) std::atomic<size_t> head;   // next to pop, written by the consumer
+    alignas(64) std::atomic<size_t> tail;   // next to push, written by the producer
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // False if the queue is full
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // False if the queue is empty
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Latest-value handoff between one writer and one reader. The writer fills
+// writeBuffer() and publishes it, the reader fetches the newest published one.
+// Neither side ever waits; values the reader didn't get to are overwritten.
+template <typename T>
+class TripleBuffer {
+private:
+    static const uint8_t INDEX_MASK = 3;
+    static const uint8_t FRESH = 4;
+
+    T buffers[3];
+    std::atomic<uint8_t> middle;   // index of the handoff slot, FRESH if not read yet
+    uint8_t back = 0;              // writer only
+    uint8_t front = 1;             // reader only
+
+public:
+    TripleBuffer() : middle(2) {}
+
+    T& writeBuffer() { return buffers[back]; }
+
+    void publish() {
+        back = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Swap in the newest published value, false if nothing new was published
+    bool fetch() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& readBuffer() const { return buffers[front]; }
+};
+
+struct TimedInput {
+    uint8_t input;        // SESSION_* encoding, see session.h
+    uint64_t micros;      // when the window thread polled the key
+};
+
+// Everything the window thread needs to draw one tick of the round
+struct WorldSnapshot {
+    uint32_t tick = 0;
+    uint64_t micros = 0;                  // when the tick was published
+    std::vector<DrawCommand> maze;        // walls, pellets and the timer bar near Pacman
+    sf::FloatRect bounds;                 // the maze's, for the window thread's camera
+    CullStats cull;                       // tiles the capture drew and skipped
+    AiLodScheduler::Stats ai;             // ghost updates run and saved this round
+    std::vector<sf::Sprite> sprites;      // ghosts, then Pacman
+    std::vector<sf::Vector2f> previous;   // sprite positions one tick earlier
+    mutable std::vector<sf::Vector2f> blended;   // window thread scratch for draw()
+    int score = 0;
+    int lives = 0;
+    bool superMode = false;
+    float superModeTimer = 0.f;
+
+    // Sprites that moved further than this in one tick teleported (tunnels,
+    // Teleporter, life lost reset) and are not blended
+    static constexpr float SNAP_DISTANCE = 60.f;
+
+    // lastPositions carries the sprite positions from one capture to the next
+    // (the buffer being filled is a few ticks old, its own sprites can't be used)
+    // camera only picks which tiles are recorded; the window thread places its
+    // own on the blended Pacman position, within Camera::MARGIN of this one
+    void capture(GameWorld& world, RenderQueue& scratch, std::vector<sf::Vector2f>& lastPositions, Camera& camera) {
+        tick = world.tick;
+        bounds = world.maze.getBounds();
+        camera.follow(world.pacman.GetPosition(), bounds);
+        cull = CullStats();
+        world.maze.draw(scratch, camera.cullRect(), &cull);
+        scratch.takeCommands(maze);
+
+        size_t count = world.ghosts.size() + 1;
+        sprites.resize(count);
+        for (size_t i = 0; i < world.ghosts.size(); ++i) {
+            sprites[i] = world.ghosts[i]->getSprite();
+        }
+        sprites[count - 1] = world.pacman.getSprite();
+
+        bool sameLineup = lastPositions.size() == count;
+        previous.resize(count);
+        lastPositions.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            previous[i] = sameLineup ? lastPositions[i] : sprites[i].getPosition();
+            lastPositions[i] = sprites[i].getPosition();
+        }
+
+        score = world.score;
+        lives = world.lives;
+        superMode = world.superMode;
+        superModeTimer = world.superModeRemaining();
+        ai = world.aiLod.getStats();
+    }
+
+    // Submit the snapshot, sprites blended blend (0..1) of the way from the
+    // previous tick to this one. camera follows the blended Pacman; sprites
+    // outside its cull rect are skipped and counted in stats with the tiles.
+    void draw(RenderQueue& queue, float blend, Camera& camera, CullStats& stats) const {
+        queue.submit(maze);
+        stats = cull;
+        if (sprites.empty()) return;
+
+        blended.resize(sprites.size());
+        for (size_t i = 0; i < sprites.size(); ++i) {
+            sf::Vector2f to = sprites[i].getPosition();
+            sf::Vector2f delta = to - previous[i];
+            blended[i] = std::abs(delta.x) + std::abs(delta.y) < SNAP_DISTANCE ? previous[i] + delta * blend : to;
+        }
+        camera.follow(blended.back(), bounds);
+
+        sf::FloatRect cullRect = camera.cullRect();
+        for (size_t i = 0; i < sprites.size(); ++i) {
+            sf::Sprite sprite = sprites[i];
+            sprite.setPosition(blended[i]);
+            GameWorld::submitCulled(queue, sprite, i + 1 < sprites.size() ? LAYER_GHOSTS : LAYER_PACMAN, cullRect, stats);
+        }
+    }
+};
+
+class SimThread {
+public:
+    static constexpr float TICK = 1.f / 60.f;
+    static const int INPUT_CAPACITY = 64;
+    static const int TRACE_CAPACITY = 256;
+    static const int MAX_CATCH_UP = 5;    // ticks run back to back after a stall before giving up on them
+
+    // Called on the simulation thread after every tick with the tick's events and
+    // the input that went into it
+    typedef std::function<void(const TickEvents&, uint8_t)> TickHook;
+
+private:
+    GameWorld& world;
+    TickHook afterTick;
+
+    SpscQueue<TimedInput, INPUT_CAPACITY> inputs;
+    SpscQueue<InputTrace, TRACE_CAPACITY> traces;
+    TripleBuffer<WorldSnapshot> snapshots;
+    RenderQueue scratch;                  // simulation thread only
+    std::vector<sf::Vector2f> lastPositions;
+    PreciseSleeper sleeper;               // simulation thread only
+    Camera camera;                        // simulation thread only, picks the tiles a snapshot records
+
+    std::thread thread;
+    std::atomic<bool> stopping;
+    std::atomic<uint8_t> events;          // EVENT_* bits not yet taken by the window thread
+    std::atomic<uint32_t> inputLatency;   // microseconds from poll to the tick that applied it
+    std::atomic<bool> tracing;
+    std::atomic<bool> lateLatch;
+    std::atomic<bool> focused;            // keyboard sampling only while the window has focus
+    bool held[4] = {};                    // late-latch key state, simulation thread only
+
+    std::chrono::steady_clock::time_point startTime;
+
+    enum : uint8_t { EVENT_SUPER_STARTED = 1, EVENT_LIFE_LOST = 2, EVENT_WON = 4 };
+
+    void publish() {
+        WorldSnapshot& snapshot = snapshots.writeBuffer();
+        snapshot.capture(world, scratch, lastPositions, camera);
+        snapshot.micros = nowMicros();
+        snapshots.publish();
+    }
+
+    // Direction of an arrow key that went down since the last sample, 0 if none
+    uint8_t sampleKeyboard() {
+        static const sf::Keyboard::Key keys[4] = { sf::Keyboard::Up, sf::Keyboard::Down, sf::Keyboard::Left, sf::Keyboard::Right };
+        static const Direction directions[4] = { UP, DOWN, LEFT, RIGHT };
+        bool active = focused.load(std::memory_order_relaxed);
+        uint8_t pressed = 0;
+        for (int i = 0; i < 4; ++i) {
+            bool down = active && sf::Keyboard::isKeyPressed(keys[i]);
+            if (down && !held[i]) pressed = static_cast<uint8_t>(directions[i] + 1);
+            held[i] = down;
+        }
+        return pressed;
+    }
+
+    // One fixed tick; false once the round can't go on without the window thread
+    bool step() {
+        // Same merge rule as the session recorder: the last direction wins, flags accumulate
+        uint8_t tickInput = 0;
+        uint64_t now = nowMicros();
+        uint32_t applying = world.tick + 1;
+        bool trace = tracing.load(std::memory_order_relaxed);
+        auto apply = [&](uint8_t input, uint64_t polled, bool latched) {
+            world.applyInput(input);
+            if (input & SESSION_DIRECTION_MASK)
+                tickInput = (tickInput & ~SESSION_DIRECTION_MASK) | input;
+            else
+                tickInput |= input;
+            // A key the window thread pushed after now was read is applied as it is polled
+            uint64_t at = std::max(now, polled);
+            inputLatency.store(static_cast<uint32_t>(at - polled), std::memory_order_relaxed);
+            if (trace) traces.push({ polled, at, applying, static_cast<uint8_t>(latched) });
+        };
+
+        TimedInput input;
+        while (inputs.pop(input)) {
+            apply(input.input, input.micros, false);
+        }
+        if (lateLatch.load(std::memory_order_relaxed)) {
+            if (uint8_t latched = sampleKeyboard()) apply(latched, now, true);
+        }
+
+        TickEvents tickEvents = world.update(TICK);
+        if (afterTick) afterTick(tickEvents, tickInput);
+        publish();
+
+        uint8_t bits = (tickEvents.superStarted ? EVENT_SUPER_STARTED : 0) |
+            (tickEvents.lifeLost ? EVENT_LIFE_LOST : 0) | (tickEvents.won ? EVENT_WON : 0);
+        if (bits) events.fetch_or(bits, std::memory_order_release);
+        return !tickEvents.lifeLost && !tickEvents.won;
+    }
+
+    void run() {
+        const float seconds = TICK;
+        const auto tick = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float>(seconds));
+        const auto maxBehind = tick * static_cast<int>(MAX_CATCH_UP);
+        auto next = std::chrono::steady_clock::now();
+
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (!step()) break;
+
+            next += tick;
+            auto now = std::chrono::steady_clock::now();
+            if (now - next > maxBehind) {
+                next = now;   // too far behind (debugger, suspend), drop the backlog
+            }
+            sleeper.sleepUntil(next);
+        }
+    }
+
+public:
+    SimThread(GameWorld& world, TickHook afterTick)
+        : world(world), afterTick(afterTick), stopping(false), events(0), inputLatency(0),
+        tracing(false), lateLatch(false), focused(true),
+        startTime(std::chrono::steady_clock::now()) {
+    }
+
+    ~SimThread() {
+        stop();
+    }
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    uint64_t nowMicros() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    // Window thread, while stopped: size of the window the snapshots are drawn to
+    void setViewSize(sf::Vector2f size) { camera.setViewSize(size); }
+
+    // Hand the world to the simulation thread
+    void start() {
+        stop();
+        lastPositions.clear();
+        publish();    // so there is a snapshot to draw before the first tick
+        stopping.store(false, std::memory_order_relaxed);
+        thread = std::thread([this] { run(); });
+    }
+
+    // Take the world back; returns once the thread has finished its tick
+    void stop() {
+        stopping.store(true, std::memory_order_release);
+        if (thread.joinable()) thread.join();
+    }
+
+    // Window thread: the world belongs to the simulation thread. Stays true after
+    // the thread stopped ticking on a lost life or a win, until stop().
+    bool isRunning() const {
+        return thread.joinable();
+    }
+
+    // Window thread, while stopped: drop key presses left over from the last round
+    void clearInput() {
+        TimedInput stale;
+        while (inputs.pop(stale)) {}
+    }
+
+    // Window thread: queue a key press for the next tick
+    bool pushInput(uint8_t input) {
+        return inputs.push({ input, nowMicros() });
+    }
+
+    // Window thread: the newest published tick
+    const WorldSnapshot& latest() {
+        snapshots.fetch();
+        return snapshots.readBuffer();
+    }
+
+    // How far the window thread is between the snapshot's previous tick and its own
+    float blend(const WorldSnapshot& snapshot) const {
+        float elapsed = (nowMicros() - snapshot.micros) * 1e-6f;
+        return std::min(1.f, std::max(0.f, elapsed / TICK));
+    }
+
+    // Window thread: events of the ticks since the last call
+    TickEvents takeEvents() {
+        uint8_t bits = events.exchange(0, std::memory_order_acquire);
+        TickEvents taken;
+        taken.superStarted = (bits & EVENT_SUPER_STARTED) != 0;
+        taken.lifeLost = (bits & EVENT_LIFE_LOST) != 0;
+        taken.won = (bits & EVENT_WON) != 0;
+        return taken;
+    }
+
+    // Window thread: report applied inputs back (see popTrace)
+    void setTracing(bool on) { tracing.store(on, std::memory_order_relaxed); }
+    bool isTracing() const { return tracing.load(std::memory_order_relaxed); }
+
+    // Window thread: an input the simulation applied since the last call
+    bool popTrace(InputTrace& trace) { return traces.pop(trace); }
+
+    // Window thread: arrow keys sampled by the simulation thread instead of pushed
+    void setLateLatch(bool on) { lateLatch.store(on, std::memory_order_relaxed); }
+    bool isLateLatch() const { return lateLatch.load(std::memory_order_relaxed); }
+
+    void setFocused(bool on) { focused.store(on, std::memory_order_relaxed); }
+
+    // Microseconds between polling the most recent key press and simulating it
+    uint32_t lastInputLatency() const {
+        return inputLatency.load(std::memory_order_relaxed);
+    }
+};
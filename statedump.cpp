@@ -0,0 +1,96 @@
+// Prints the live game state published by the running game (see sharedstate.h).
+//
+//     g++ -O2 -std=c++20 statedump.cpp -o statedump      (add -lrt on older glibc)
+//     ./statedump            redraw ten times a second until the game exits
+//     ./statedump --once     print a single state and quit
+#include "sharedstate.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+static const int CELL_SIZE = 40;          // Maze::CELL_SIZE
+static const float OFFSET_X = 60.f;       // Maze offset
+static const float OFFSET_Y = 40.f;
+
+static const char* ghostKindName(uint8_t kind) {
+    switch (kind) {
+    case GHOST_RING: return "RING";
+    case GHOST_TELEPORTER: return "TELEPORTER";
+    case GHOST_PHANTOM: return "PHANTOM";
+    case GHOST_AMBUSHER: return "AMBUSHER";
+    case GHOST_TIMESTOP: return "TIMESTOP";
+    case GHOST_CHASER: return "CHASER";
+    default: return "GHOST";
+    }
+}
+
+static void printState(const GameState& s, uint64_t publishCount) {
+    std::string board;
+    for (int row = 0; row < s.height; ++row) {
+        std::string line(s.width, ' ');
+        for (int col = 0; col < s.width; ++col) {
+            if (s.isWall(row, col)) line[col] = '#';
+            else if (s.hasPellet(row, col)) line[col] = '.';
+            else if (s.hasEnergizer(row, col)) line[col] = 'o';
+        }
+        board += line;
+        board += '\n';
+    }
+
+    auto mark = [&](float x, float y, char c) {
+        int col = static_cast<int>((x - OFFSET_X) / CELL_SIZE);
+        int row = static_cast<int>((y - OFFSET_Y) / CELL_SIZE);
+        if (row >= 0 && row < s.height && col >= 0 && col < s.width)
+            board[row * (s.width + 1) + col] = c;
+    };
+    mark(s.pacmanX, s.pacmanY, 'C');
+    for (int i = 0; i < s.ghostCount; ++i) {
+        mark(s.ghosts[i].x, s.ghosts[i].y, static_cast<char>('A' + i));
+    }
+
+    std::printf("\x1b[H\x1b[2J");
+    std::printf("tick %u  (published %llu)  score %d  lives %d  food %d\n",
+        s.tick, static_cast<unsigned long long>(publishCount), s.score, s.lives, s.totalFood);
+    std::printf("super %s %.1fs   game time %.1fs   pacman (%.0f, %.0f)%s\n",
+        s.superMode ? "ON " : "off", s.superModeTimer, s.gameTimer, s.pacmanX, s.pacmanY,
+        s.pacmanFrozen ? " FROZEN" : "");
+    for (int i = 0; i < s.ghostCount; ++i) {
+        const GhostState& g = s.ghosts[i];
+        std::printf("  %c %-10s (%.0f, %.0f) speed %.1f timers %.1f %.1f %.1f flags %03x%s\n",
+            'A' + i, ghostKindName(g.kind), g.x, g.y, g.speed, g.timers[0], g.timers[1], g.timers[2],
+            g.flags, s.ghostsBlinking[i] ? " eaten" : "");
+    }
+    std::fputs(board.c_str(), stdout);
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    bool once = argc > 1 && std::strcmp(argv[1], "--once") == 0;
+
+    SharedStateReader reader;
+    if (!reader.open()) {
+        std::fprintf(stderr, "No game state at %s (is the game running, same version?)\n", SHARED_STATE_NAME);
+        return 1;
+    }
+
+    GameState state;
+    uint64_t count = 0, lastCount = ~0ull;
+    int stale = 0;
+    while (true) {
+        if (reader.read(state, &count)) {
+            if (count != lastCount) {
+                printState(state, count);
+                lastCount = count;
+                stale = 0;
+            }
+            else if (++stale > 50) {
+                std::printf("\nNo new state for 5 seconds, game paused or closed.\n");
+                return 0;
+            }
+            if (once) return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
@@ -0,0 +1,215 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Hierarchical timing wheel on simulation ticks.
+//
+// Four levels of 64 slots. Level 0 has one slot per tick for the next 64
+// ticks, level 1 one slot per 64 ticks for the next 4096, and so on up to
+// 2^24 ticks (about three days at 60 Hz). Timers further out wait in the last
+// level and are filed again when their slot comes round.
+//
+// advance() moves one tick. Whenever a level wraps, the current slot of the
+// level above is emptied into the levels below it (a cascade). Then
+// everything in level 0's slot for the tick fires. A tick therefore costs
+// O(timers that fire or cascade), however many timers are pending.
+//
+// Time is counted in ticks, never in seconds, so timers fire on the same tick
+// in every replay. Timers due on the same tick fire in the order they reached
+// the slot, which depends only on the order of schedule() calls. A callback
+// may schedule and cancel timers, including its own follow-up.
+//
+// Single-threaded; the owner advances it once per tick.
+
+class TimerWheel {
+public:
+    typedef uint32_t TimerId;                          // 0 is never a timer
+    typedef std::function<void(uint32_t)> Callback;    // gets the data it was scheduled with
+
+    static const uint32_t TICK_RATE = 60;              // the simulation's, SimThread::TICK
+
+    // Gameplay durations are written in seconds; nothing negative
+    static uint32_t ticksFor(float seconds) {
+        return seconds > 0.f ? static_cast<uint32_t>(std::lround(seconds * TICK_RATE)) : 0;
+    }
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const uint32_t SLOTS = 1u << SLOT_BITS;
+    static const uint32_t RANGE = 1u << (SLOT_BITS * LEVELS);
+    static const uint32_t NONE = 0xffffffffu;
+
+    // TimerId: node index + 1 in the low bits, the node's generation above, so
+    // an id stays invalid after its timer fired or was cancelled
+    static const int INDEX_BITS = 20;
+    static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    struct Node {
+        uint32_t due = 0;
+        uint32_t data = 0;
+        uint32_t generation = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;          // slot list, or the free list
+        uint32_t slot = NONE;          // level * SLOTS + index while pending
+        Callback callback;
+    };
+
+    std::vector<Node> nodes;
+    uint32_t heads[LEVELS * SLOTS];
+    uint32_t tails[LEVELS * SLOTS];
+    uint32_t freeList = NONE;
+    uint32_t current = 0;
+    size_t pendingCount = 0;
+
+    TimerId idOf(uint32_t index) const {
+        return ((nodes[index].generation << INDEX_BITS) | (index + 1));
+    }
+
+    // Index of the pending node id refers to, NONE if there is none
+    uint32_t find(TimerId id) const {
+        uint32_t index = (id & INDEX_MASK) - 1;
+        if (id == 0 || index >= nodes.size()) return NONE;
+        const Node& node = nodes[index];
+        if (node.slot == NONE || idOf(index) != id) return NONE;
+        return index;
+    }
+
+    void link(uint32_t index, uint32_t slot) {
+        Node& node = nodes[index];
+        node.slot = slot;
+        node.prev = tails[slot];
+        node.next = NONE;
+        if (tails[slot] != NONE) nodes[tails[slot]].next = index;
+        else heads[slot] = index;
+        tails[slot] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes[index];
+        if (node.prev != NONE) nodes[node.prev].next = node.next;
+        else heads[node.slot] = node.next;
+        if (node.next != NONE) nodes[node.next].prev = node.prev;
+        else tails[node.slot] = node.prev;
+        node.slot = NONE;
+    }
+
+    void release(uint32_t index) {
+        Node& node = nodes[index];
+        node.callback = nullptr;
+        node.generation = (node.generation + 1) & (0xffffffffu >> INDEX_BITS);
+        node.next = freeList;
+        freeList = index;
+        pendingCount--;
+    }
+
+    // Put a node in the slot for its due tick, as seen from the current one
+    void file(uint32_t index) {
+        uint32_t due = nodes[index].due;
+        uint32_t delta = due - current;
+        if (delta >= RANGE) {
+            due = current + RANGE - 1;     // the last level's furthest slot, filed again from there
+            delta = RANGE - 1;
+        }
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1u << (SLOT_BITS * (level + 1)))) level++;
+        link(index, level * SLOTS + ((due >> (SLOT_BITS * level)) & (SLOTS - 1)));
+    }
+
+    void cascade(int level) {
+        uint32_t slot = level * SLOTS + ((current >> (SLOT_BITS * level)) & (SLOTS - 1));
+        uint32_t index = heads[slot];
+        heads[slot] = tails[slot] = NONE;
+        while (index != NONE) {
+            uint32_t next = nodes[index].next;
+            file(index);
+            index = next;
+        }
+    }
+
+public:
+    TimerWheel() { reset(0); }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Drop every timer and start counting at now. Keeps the node storage, so a
+    // round that schedules as much as the last one doesn't allocate.
+    void reset(uint32_t now) {
+        for (uint32_t slot = 0; slot < LEVELS * SLOTS; ++slot) {
+            heads[slot] = tails[slot] = NONE;
+        }
+        freeList = NONE;
+        for (uint32_t i = static_cast<uint32_t>(nodes.size()); i-- > 0;) {
+            Node& node = nodes[i];
+            node.callback = nullptr;
+            if (node.slot != NONE) node.generation = (node.generation + 1) & (0xffffffffu >> INDEX_BITS);
+            node.slot = NONE;
+            node.next = freeList;
+            freeList = i;
+        }
+        current = now;
+        pendingCount = 0;
+    }
+
+    uint32_t now() const { return current; }
+    size_t pending() const { return pendingCount; }
+
+    // Call callback(data) on the delay-th advance from now (at least the next)
+    TimerId schedule(uint32_t delay, Callback callback, uint32_t data = 0) {
+        uint32_t index = freeList;
+        if (index != NONE) {
+            freeList = nodes[index].next;
+        }
+        else {
+            index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node());
+        }
+        Node& node = nodes[index];
+        node.due = current + (delay > 0 ? delay : 1);
+        node.data = data;
+        node.callback = std::move(callback);
+        pendingCount++;
+        file(index);
+        return idOf(index);
+    }
+
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerId id) {
+        uint32_t index = find(id);
+        if (index == NONE) return false;
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    bool isPending(TimerId id) const { return find(id) != NONE; }
+
+    // Ticks until the timer fires, 0 if it isn't pending
+    uint32_t remaining(TimerId id) const {
+        uint32_t index = find(id);
+        return index == NONE ? 0 : nodes[index].due - current;
+    }
+
+    // One tick: cascade what comes into range, then fire what is due
+    void advance() {
+        current++;
+        for (int level = LEVELS - 1; level > 0; --level) {
+            if ((current & ((1u << (SLOT_BITS * level)) - 1)) == 0) cascade(level);
+        }
+
+        uint32_t slot = current & (SLOTS - 1);
+        while (heads[slot] != NONE) {
+            uint32_t index = heads[slot];
+            unlink(index);
+            Callback callback = std::move(nodes[index].callback);
+            uint32_t data = nodes[index].data;
+            release(index);
+            callback(data);
+        }
+    }
+};
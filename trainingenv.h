@@ -0,0 +1,287 @@
+#pragma once
+#include "maze.h"
+#include "animation.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Batched, headless training environment over the maze.
+//
+// N environments are stepped in lockstep on a tile grid (one tile per step for
+// every entity) and their state is kept as structure-of-arrays, so a step is a
+// handful of tight loops over flat vectors with no allocation. Tile data comes
+// from Maze, so the environment plays on exactly the board the game uses.
+//
+// Observations are uint8 planes laid out [env][plane][row][col]:
+//     0 walls, 1 pellets, 2 energizers, 3 pacman, 4 ghosts, 5 super mode (all ones)
+//
+// Actions are Direction values (RIGHT, UP, DOWN, LEFT); anything else keeps the
+// current heading. Ghost actions are optional, without them ghosts wander like
+// Ghost::updateAutonomous (keep going, pick a random non-reversing turn when blocked).
+//
+// Rewards are from Pacman's point of view; a ghost policy trains on the negation.
+// A finished environment is reset on the spot and its observation is the first
+// of the new episode, like a gym vector env with autoreset.
+// Tuning shared by every environment in a batch
+struct TrainingEnvConfig {
+    int maxSteps = 2000;
+    int superSteps = 60;          // energizer duration in steps
+    float pelletReward = 1.0f;
+    float energizerReward = 5.0f;
+    float ghostReward = 20.0f;
+    float deathReward = -50.0f;
+    float clearReward = 100.0f;
+};
+
+class TrainingEnv {
+public:
+    static const int PLANES = 6;
+    static const int GHOSTS = 4;
+    static const int NO_ACTION = -1;
+
+private:
+    int numEnvs;
+    int width, height, tiles;
+    TrainingEnvConfig config;
+
+    // Board data shared by all environments
+    std::vector<uint8_t> wallPlane;
+    std::vector<uint8_t> startFood;       // 0 none, 1 pellet, 2 energizer
+    std::vector<int32_t> neighbour;       // tiles * 4, -1 where blocked (tunnels wrap)
+    int startFoodCount;
+    int pacmanSpawn;
+    int ghostSpawn[GHOSTS];
+
+    // Per-environment state, structure of arrays
+    std::vector<uint8_t> food;            // numEnvs * tiles
+    std::vector<int32_t> foodLeft;
+    std::vector<int32_t> pacTile;
+    std::vector<uint8_t> pacDir;
+    std::vector<int32_t> ghostTile;       // numEnvs * GHOSTS
+    std::vector<uint8_t> ghostDir;
+    std::vector<int32_t> superLeft;
+    std::vector<int32_t> steps;
+    std::vector<uint32_t> rng;
+
+    static uint32_t nextRandom(uint32_t& state) {
+        // xorshift32, state is never zero
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    static int opposite(int dir) {
+        switch (dir) {
+        case UP: return DOWN;
+        case DOWN: return UP;
+        case LEFT: return RIGHT;
+        default: return LEFT;
+        }
+    }
+
+    void resetEnv(int e) {
+        std::memcpy(&food[static_cast<size_t>(e) * tiles], startFood.data(), tiles);
+        foodLeft[e] = startFoodCount;
+        pacTile[e] = pacmanSpawn;
+        pacDir[e] = LEFT;
+        for (int g = 0; g < GHOSTS; ++g) {
+            ghostTile[e * GHOSTS + g] = ghostSpawn[g];
+            ghostDir[e * GHOSTS + g] = UP;
+        }
+        superLeft[e] = 0;
+        steps[e] = 0;
+    }
+
+    void moveGhost(int e, int g, int action) {
+        int slot = e * GHOSTS + g;
+        int tile = ghostTile[slot];
+        int dir = ghostDir[slot];
+        const int32_t* next = &neighbour[tile * 4];
+
+        if (action >= 0 && action < 4 && next[action] >= 0) {
+            dir = action;
+        }
+        else if (next[dir] < 0) {
+            // Blocked, pick a random open direction that doesn't reverse
+            int options[4];
+            int count = 0;
+            for (int d = 0; d < 4; ++d) {
+                if (d != opposite(dir) && next[d] >= 0) options[count++] = d;
+            }
+            if (count == 0) dir = opposite(dir);
+            else dir = options[nextRandom(rng[e]) % count];
+        }
+
+        if (next[dir] >= 0) {
+            ghostTile[slot] = next[dir];
+        }
+        ghostDir[slot] = static_cast<uint8_t>(dir);
+    }
+
+    void writeObservation(int e, uint8_t* obs) const {
+        size_t plane = static_cast<size_t>(tiles);
+        uint8_t* out = obs + static_cast<size_t>(e) * PLANES * plane;
+        const uint8_t* envFood = &food[static_cast<size_t>(e) * tiles];
+
+        std::memcpy(out, wallPlane.data(), plane);
+        uint8_t* pellets = out + plane;
+        uint8_t* energizers = out + 2 * plane;
+        for (int t = 0; t < tiles; ++t) {
+            pellets[t] = envFood[t] == 1;
+            energizers[t] = envFood[t] == 2;
+        }
+        std::memset(out + 3 * plane, 0, 2 * plane);
+        out[3 * plane + pacTile[e]] = 1;
+        for (int g = 0; g < GHOSTS; ++g) {
+            out[4 * plane + ghostTile[e * GHOSTS + g]] = 1;
+        }
+        std::memset(out + 5 * plane, superLeft[e] > 0 ? 1 : 0, plane);
+    }
+
+public:
+    TrainingEnv(int numEnvs, const TrainingEnvConfig& config = TrainingEnvConfig())
+        : numEnvs(numEnvs), config(config), startFoodCount(0)
+    {
+        Maze maze;
+        width = maze.getWidth();
+        height = maze.getHeight();
+        tiles = width * height;
+
+        wallPlane.assign(tiles, 0);
+        startFood.assign(tiles, 0);
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                char tile = maze.getTile(row, col);
+                int t = row * width + col;
+                wallPlane[t] = tile == '#';
+                if (tile == '.') startFood[t] = 1;
+                if (tile == 'o') startFood[t] = 2;
+                if (startFood[t]) startFoodCount++;
+            }
+        }
+
+        // Neighbour table, stepping off a side edge wraps to the other (tunnel)
+        neighbour.assign(static_cast<size_t>(tiles) * 4, -1);
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                int t = row * width + col;
+                if (wallPlane[t]) continue;
+                const int dRow[4] = { 0, -1, 1, 0 };   // RIGHT, UP, DOWN, LEFT
+                const int dCol[4] = { 1, 0, 0, -1 };
+                for (int d = 0; d < 4; ++d) {
+                    int r = row + dRow[d];
+                    int c = (col + dCol[d] + width) % width;
+                    if (r < 0 || r >= height) continue;
+                    if (!wallPlane[r * width + c]) neighbour[t * 4 + d] = r * width + c;
+                }
+            }
+        }
+
+        Vector2i p = maze.getP();
+        pacmanSpawn = p.y * width + p.x;
+        for (int g = 0; g < GHOSTS; ++g) {
+            Vector2i cell = maze.getGhost(static_cast<char>('0' + g));
+            if (cell.x < 0) cell = maze.getGhost('0');
+            ghostSpawn[g] = cell.y * width + cell.x;
+        }
+
+        food.assign(static_cast<size_t>(numEnvs) * tiles, 0);
+        foodLeft.assign(numEnvs, 0);
+        pacTile.assign(numEnvs, 0);
+        pacDir.assign(numEnvs, LEFT);
+        ghostTile.assign(static_cast<size_t>(numEnvs) * GHOSTS, 0);
+        ghostDir.assign(static_cast<size_t>(numEnvs) * GHOSTS, UP);
+        superLeft.assign(numEnvs, 0);
+        steps.assign(numEnvs, 0);
+        rng.assign(numEnvs, 1);
+    }
+
+    int getNumEnvs() const { return numEnvs; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t observationSize() const { return static_cast<size_t>(PLANES) * tiles; }
+
+    // Reset every environment. Each gets its own random stream derived from seed.
+    // obs may be null, otherwise it receives numEnvs * observationSize() bytes.
+    void reset(uint64_t seed, uint8_t* obs = nullptr) {
+        for (int e = 0; e < numEnvs; ++e) {
+            // splitmix64 so neighbouring envs get unrelated streams
+            uint64_t z = seed + 0x9E3779B97F4A7C15ull * (e + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            rng[e] = static_cast<uint32_t>(z) | 1u;
+            resetEnv(e);
+            if (obs) writeObservation(e, obs);
+        }
+    }
+
+    // Advance every environment by one step.
+    // pacmanActions: numEnvs entries. ghostActions: numEnvs * GHOSTS entries, or null.
+    // obs (optional): numEnvs * observationSize() bytes. rewards/dones: numEnvs entries.
+    void step(const int32_t* pacmanActions, const int32_t* ghostActions,
+        uint8_t* obs, float* rewards, uint8_t* dones) {
+        for (int e = 0; e < numEnvs; ++e) {
+            float reward = 0.f;
+            bool done = false;
+            uint8_t* envFood = &food[static_cast<size_t>(e) * tiles];
+            if (superLeft[e] > 0) superLeft[e]--;
+
+            // Pacman turns if the new heading is open, otherwise keeps going
+            int action = pacmanActions[e];
+            int from = pacTile[e];
+            if (action >= 0 && action < 4 && neighbour[from * 4 + action] >= 0) {
+                pacDir[e] = static_cast<uint8_t>(action);
+            }
+            int to = neighbour[from * 4 + pacDir[e]];
+            if (to >= 0) pacTile[e] = to;
+
+            if (envFood[pacTile[e]]) {
+                if (envFood[pacTile[e]] == 2) {
+                    reward += config.energizerReward;
+                    superLeft[e] = config.superSteps;
+                }
+                else {
+                    reward += config.pelletReward;
+                }
+                envFood[pacTile[e]] = 0;
+                foodLeft[e]--;
+            }
+
+            for (int g = 0; g < GHOSTS; ++g) {
+                int slot = e * GHOSTS + g;
+                int before = ghostTile[slot];
+                moveGhost(e, g, ghostActions ? ghostActions[slot] : NO_ACTION);
+
+                // Same tile, or the two swapped tiles and passed through each other
+                bool hit = ghostTile[slot] == pacTile[e] ||
+                    (ghostTile[slot] == from && before == pacTile[e]);
+                if (!hit) continue;
+
+                if (superLeft[e] > 0) {
+                    reward += config.ghostReward;
+                    ghostTile[slot] = ghostSpawn[g];
+                    ghostDir[slot] = UP;
+                }
+                else {
+                    // The episode is over, the ghosts after this one don't get to move
+                    reward += config.deathReward;
+                    done = true;
+                    break;
+                }
+            }
+
+            if (!done && foodLeft[e] == 0) {
+                reward += config.clearReward;
+                done = true;
+            }
+            if (++steps[e] >= config.maxSteps) done = true;
+
+            if (done) resetEnv(e);
+            if (rewards) rewards[e] = reward;
+            if (dones) dones[e] = done;
+            if (obs) writeObservation(e, obs);
+        }
+    }
+};